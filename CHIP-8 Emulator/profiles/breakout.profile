@@ -0,0 +1,107 @@
+instructions 9360
+pair SeVxByte Jp 439
+pair SneVxByte Jp 5
+pair SneVxByte LdVxByte 2
+pair LdVxByte SneVxByte 2
+pair LdVxByte LdVxByte 94
+pair LdVxByte LdVxVy 5
+pair LdVxByte AndVxVy 870
+pair LdVxByte XorVxVy 39
+pair LdVxByte SubVxVy 42
+pair LdVxByte LdI 13
+pair LdVxByte Drw 84
+pair LdVxByte Sknp 554
+pair LdVxByte LdDtVx 5
+pair LdVxByte LdStVx 44
+pair AddVxByte Call 39
+pair AddVxByte SeVxByte 102
+pair AddVxByte LdVxVy 5
+pair AddVxByte LdI 1
+pair AddVxByte LdFVx 79
+pair LdVxVy LdVxByte 39
+pair LdVxVy AddVxVy 5
+pair LdVxVy SubVxVy 5
+pair AndVxVy SneVxByte 277
+pair AndVxVy LdVxByte 277
+pair AndVxVy LdI 39
+pair AndVxVy Drw 277
+pair XorVxVy Call 39
+pair AddVxVy LdVxByte 282
+pair AddVxVy AddVxVy 277
+pair SubVxVy SeVxByte 53
+pair LdI AddVxByte 5
+pair LdI Drw 697
+pair LdI LdBVx 79
+pair Rnd LdVxByte 5
+pair Drw Ret 79
+pair Drw Call 1
+pair Drw SeVxByte 277
+pair Drw LdVxByte 317
+pair Drw AddVxByte 176
+pair Drw AddVxVy 277
+pair Drw LdI 282
+pair LdVxDt SeVxByte 110
+pair LdDtVx LdVxDt 5
+pair LdStVx LdVxVy 39
+pair LdStVx LdI 5
+pair LdFVx LdVxByte 79
+pair LdFVx Drw 79
+pair LdBVx LdVxI 79
+pair LdVxI LdFVx 79
+triple SneVxByte LdVxByte SneVxByte 2
+triple LdVxByte LdVxByte LdVxByte 7
+triple LdVxByte LdVxByte LdI 8
+triple LdVxByte LdVxByte Drw 79
+triple LdVxByte LdVxVy SubVxVy 5
+triple LdVxByte AndVxVy SneVxByte 277
+triple LdVxByte AndVxVy LdVxByte 277
+triple LdVxByte AndVxVy LdI 39
+triple LdVxByte AndVxVy Drw 277
+triple LdVxByte XorVxVy Call 39
+triple LdVxByte SubVxVy SeVxByte 42
+triple LdVxByte LdI Drw 13
+triple LdVxByte Drw SeVxByte 5
+triple LdVxByte Drw AddVxByte 79
+triple LdVxByte LdDtVx LdVxDt 5
+triple LdVxByte LdStVx LdVxVy 39
+triple LdVxByte LdStVx LdI 5
+triple AddVxByte SeVxByte Jp 95
+triple AddVxByte LdVxVy AddVxVy 5
+triple AddVxByte LdI Drw 1
+triple AddVxByte LdFVx Drw 79
+triple LdVxVy LdVxByte AndVxVy 39
+triple LdVxVy AddVxVy LdVxByte 5
+triple LdVxVy SubVxVy SeVxByte 5
+triple AndVxVy SneVxByte Jp 5
+triple AndVxVy LdVxByte AndVxVy 277
+triple AndVxVy LdI Drw 39
+triple AndVxVy Drw LdI 277
+triple AddVxVy LdVxByte AndVxVy 277
+triple AddVxVy LdVxByte Drw 5
+triple AddVxVy AddVxVy LdVxByte 277
+triple SubVxVy SeVxByte Jp 2
+triple LdI AddVxByte LdVxVy 5
+triple LdI Drw Call 1
+triple LdI Drw LdVxByte 317
+triple LdI Drw AddVxByte 97
+triple LdI Drw AddVxVy 277
+triple LdI Drw LdI 5
+triple LdI LdBVx LdVxI 79
+triple Rnd LdVxByte LdVxByte 5
+triple Drw SeVxByte Jp 237
+triple Drw LdVxByte XorVxVy 39
+triple Drw LdVxByte Sknp 277
+triple Drw LdVxByte LdDtVx 1
+triple Drw AddVxByte SeVxByte 96
+triple Drw AddVxByte LdI 1
+triple Drw AddVxByte LdFVx 79
+triple Drw AddVxVy AddVxVy 277
+triple Drw LdI Drw 282
+triple LdVxDt SeVxByte Jp 105
+triple LdDtVx LdVxDt SeVxByte 5
+triple LdStVx LdVxVy LdVxByte 39
+triple LdStVx LdI AddVxByte 5
+triple LdFVx LdVxByte LdVxByte 79
+triple LdFVx Drw Ret 79
+triple LdBVx LdVxI LdFVx 79
+triple LdVxI LdFVx LdVxByte 79
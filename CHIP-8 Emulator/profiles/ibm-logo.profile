@@ -0,0 +1,24 @@
+instructions 21
+pair Cls LdI 1
+pair LdVxByte LdVxByte 1
+pair LdVxByte Drw 1
+pair AddVxByte LdI 4
+pair AddVxByte Drw 1
+pair LdI LdVxByte 1
+pair LdI AddVxByte 1
+pair LdI Drw 4
+pair Drw Jp 1
+pair Drw AddVxByte 4
+pair Drw LdI 1
+triple Cls LdI LdVxByte 1
+triple LdVxByte LdVxByte Drw 1
+triple LdVxByte Drw AddVxByte 1
+triple AddVxByte LdI Drw 4
+triple AddVxByte Drw AddVxByte 1
+triple LdI LdVxByte LdVxByte 1
+triple LdI AddVxByte Drw 1
+triple LdI Drw Jp 1
+triple LdI Drw AddVxByte 2
+triple LdI Drw LdI 1
+triple Drw AddVxByte LdI 4
+triple Drw LdI AddVxByte 1
@@ -0,0 +1,27 @@
+instructions 339
+pair Cls LdVxByte 1
+pair SeVxByte Jp 15
+pair LdVxByte Call 1
+pair AddVxByte Call 16
+pair AddVxByte SeVxByte 16
+pair AddVxByte AddVxByte 16
+pair ShrVx LdIVx 16
+pair ShrVx LdVxI 16
+pair ShlVx AddIVx 32
+pair LdI ShlVx 32
+pair Drw AddVxByte 16
+pair AddIVx ShrVx 32
+pair LdFVx Drw 16
+pair LdIVx Ret 16
+pair LdVxI Ret 16
+triple Cls LdVxByte Call 1
+triple AddVxByte SeVxByte Jp 15
+triple AddVxByte AddVxByte Call 16
+triple ShrVx LdIVx Ret 16
+triple ShrVx LdVxI Ret 16
+triple ShlVx AddIVx ShrVx 32
+triple LdI ShlVx AddIVx 32
+triple Drw AddVxByte AddVxByte 16
+triple AddIVx ShrVx LdIVx 16
+triple AddIVx ShrVx LdVxI 16
+triple LdFVx Drw AddVxByte 16
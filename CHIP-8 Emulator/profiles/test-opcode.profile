@@ -0,0 +1,100 @@
+instructions 203
+pair SneVxByte LdI 11
+pair SeVxVy LdI 1
+pair LdVxByte LdVxByte 16
+pair LdVxByte OrVxVy 1
+pair LdVxByte AndVxVy 1
+pair LdVxByte XorVxVy 1
+pair LdVxByte AddVxVy 1
+pair LdVxByte SubVxVy 1
+pair LdVxByte ShrVx 1
+pair LdVxByte ShlVx 1
+pair LdVxByte LdI 18
+pair LdVxByte LdBVx 1
+pair LdVxByte LdIVx 1
+pair AddVxByte SneVxByte 1
+pair LdVxVy SneVxByte 1
+pair OrVxVy SneVxByte 1
+pair AndVxVy SneVxByte 1
+pair XorVxVy SneVxByte 1
+pair AddVxVy SneVxByte 1
+pair SubVxVy SneVxByte 1
+pair ShrVx SneVxByte 1
+pair ShlVx SneVxByte 1
+pair SneVxVy LdI 1
+pair LdI SeVxByte 2
+pair LdI SneVxByte 2
+pair LdI SeVxVy 1
+pair LdI LdVxByte 9
+pair LdI AddVxByte 1
+pair LdI LdVxVy 1
+pair LdI SneVxVy 1
+pair LdI Drw 52
+pair LdI LdVxI 1
+pair Drw Ret 1
+pair Drw Jp 2
+pair Drw Call 1
+pair Drw LdVxByte 16
+pair Drw LdI 34
+pair LdBVx LdVxI 1
+pair LdIVx LdI 1
+pair LdVxI LdI 2
+triple SneVxByte LdI Drw 11
+triple SeVxVy LdI Drw 1
+triple LdVxByte LdVxByte LdVxByte 8
+triple LdVxByte LdVxByte AndVxVy 1
+triple LdVxByte LdVxByte XorVxVy 1
+triple LdVxByte LdVxByte AddVxVy 1
+triple LdVxByte LdVxByte SubVxVy 1
+triple LdVxByte LdVxByte LdI 3
+triple LdVxByte LdVxByte LdIVx 1
+triple LdVxByte OrVxVy SneVxByte 1
+triple LdVxByte AndVxVy SneVxByte 1
+triple LdVxByte XorVxVy SneVxByte 1
+triple LdVxByte AddVxVy SneVxByte 1
+triple LdVxByte SubVxVy SneVxByte 1
+triple LdVxByte ShrVx SneVxByte 1
+triple LdVxByte ShlVx SneVxByte 1
+triple LdVxByte LdI Drw 18
+triple LdVxByte LdBVx LdVxI 1
+triple LdVxByte LdIVx LdI 1
+triple AddVxByte SneVxByte LdI 1
+triple LdVxVy SneVxByte LdI 1
+triple OrVxVy SneVxByte LdI 1
+triple AndVxVy SneVxByte LdI 1
+triple XorVxVy SneVxByte LdI 1
+triple AddVxVy SneVxByte LdI 1
+triple SubVxVy SneVxByte LdI 1
+triple ShrVx SneVxByte LdI 1
+triple ShlVx SneVxByte LdI 1
+triple SneVxVy LdI Drw 1
+triple LdI SneVxByte LdI 2
+triple LdI SeVxVy LdI 1
+triple LdI LdVxByte LdVxByte 5
+triple LdI LdVxByte OrVxVy 1
+triple LdI LdVxByte ShrVx 1
+triple LdI LdVxByte ShlVx 1
+triple LdI LdVxByte LdBVx 1
+triple LdI AddVxByte SneVxByte 1
+triple LdI LdVxVy SneVxByte 1
+triple LdI SneVxVy LdI 1
+triple LdI Drw Ret 1
+triple LdI Drw Jp 2
+triple LdI Drw Call 1
+triple LdI Drw LdVxByte 14
+triple LdI Drw LdI 34
+triple LdI LdVxI LdI 1
+triple Drw LdVxByte LdVxByte 1
+triple Drw LdVxByte LdI 15
+triple Drw LdI SeVxByte 1
+triple Drw LdI SneVxByte 1
+triple Drw LdI SeVxVy 1
+triple Drw LdI LdVxByte 9
+triple Drw LdI AddVxByte 1
+triple Drw LdI LdVxVy 1
+triple Drw LdI SneVxVy 1
+triple Drw LdI Drw 19
+triple LdBVx LdVxI LdI 1
+triple LdIVx LdI LdVxI 1
+triple LdVxI LdI SeVxByte 1
+triple LdVxI LdI SneVxByte 1
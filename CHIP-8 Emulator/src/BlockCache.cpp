@@ -0,0 +1,159 @@
+#include "BlockCache.h"
+#include "Chip8.h"
+
+template <void (Chip8::*Handler)(const Instruction&)>
+void BlockCache::bind(Chip8& chip8, const Instruction& in)
+{
+    (chip8.*Handler)(in);
+}
+
+template <class Q>
+const BlockCache::MicroHandler BlockCache::MicroHandlers<Q>::TABLE[static_cast<int>(Op::Count)] =
+{
+    &bind<&Chip8::opInvalid>,   // Undecoded
+    &bind<&Chip8::opInvalid>,   // Invalid
+    &bind<&Chip8::opCls>,
+    &bind<&Chip8::opRet>,
+    &bind<&Chip8::opJp>,
+    &bind<&Chip8::opCall>,
+    &bind<&Chip8::opSeVxByte>,
+    &bind<&Chip8::opSneVxByte>,
+    &bind<&Chip8::opSeVxVy>,
+    &bind<&Chip8::opLdVxByte>,
+    &bind<&Chip8::opAddVxByte>,
+    &bind<&Chip8::opLdVxVy>,
+    &bind<&Chip8::opOrVxVy<Q>>,
+    &bind<&Chip8::opAndVxVy<Q>>,
+    &bind<&Chip8::opXorVxVy<Q>>,
+    &bind<&Chip8::opAddVxVy>,
+    &bind<&Chip8::opSubVxVy>,
+    &bind<&Chip8::opShrVx<Q>>,
+    &bind<&Chip8::opSubnVxVy>,
+    &bind<&Chip8::opShlVx<Q>>,
+    &bind<&Chip8::opSneVxVy>,
+    &bind<&Chip8::opLdI>,
+    &bind<&Chip8::opJpV0<Q>>,
+    &bind<&Chip8::opRnd>,
+    &bind<&Chip8::opDrw<Q>>,
+    &bind<&Chip8::opSkp>,
+    &bind<&Chip8::opSknp>,
+    &bind<&Chip8::opLdVxDt>,
+    &bind<&Chip8::opLdVxK>,
+    &bind<&Chip8::opLdDtVx>,
+    &bind<&Chip8::opLdStVx>,
+    &bind<&Chip8::opAddIVx>,
+    &bind<&Chip8::opLdFVx>,
+    &bind<&Chip8::opLdBVx>,
+    &bind<&Chip8::opLdIVx<Q>>,
+    &bind<&Chip8::opLdVxI<Q>>
+};
+
+void BlockCache::run(Chip8& chip8, int cycles)
+{
+    while (cycles > 0)
+    {
+        // Handlers advance pc relative to itself, so a block found at the
+        // wrapped address runs correctly for a pc past the end of memory.
+        // An opcode straddling the end of memory is left to the interpreter.
+        const std::uint16_t address = chip8.state.pc & (MEMORY_SIZE - 1);
+        if (address == MEMORY_SIZE - 1)
+        {
+            chip8.executeOpcode();
+            --cycles;
+            continue;
+        }
+
+        const Block& block = lookup(chip8, address);
+        const unsigned int blockGeneration = generation;
+        const MicroOp* op = block.ops.data();
+        const MicroOp* last = op + block.ops.size();
+
+        for (; op != last; ++op)
+        {
+            // A store can erase this block while its handler still runs,
+            // so the handler works on a copy of the op
+            const MicroOp current = *op;
+            current.handler(chip8, current.instruction);
+
+            // A store may have invalidated this block; pc is already
+            // correct, so resume from a fresh lookup.
+            if (--cycles == 0 || generation != blockGeneration)
+            {
+                break;
+            }
+        }
+    }
+}
+
+void BlockCache::invalidate(std::uint16_t address)
+{
+    if (address >= MEMORY_SIZE || coverage[address] == 0)
+    {
+        return;
+    }
+
+    // Only blocks starting within one maximal block length can span address
+    int first = address - 2 * MAX_BLOCK_LENGTH + 1;
+    for (int start = first < 0 ? 0 : first; start <= address; ++start)
+    {
+        if (blocks[start] && address < blocks[start]->end)
+        {
+            erase(start);
+        }
+    }
+    ++generation;
+}
+
+void BlockCache::clear()
+{
+    for (int start = 0; start < MEMORY_SIZE; ++start)
+    {
+        blocks[start].reset();
+        coverage[start] = 0;
+    }
+    ++generation;
+}
+
+void BlockCache::setQuirks(const Quirks& quirks)
+{
+    microHandlers = selectQuirkPolicy<MicroHandlerFactory>(quirks);
+    clear();
+}
+
+void BlockCache::erase(int start)
+{
+    for (int i = blocks[start]->start; i < blocks[start]->end; ++i)
+    {
+        --coverage[i];
+    }
+    blocks[start].reset();
+}
+
+const BlockCache::Block& BlockCache::lookup(Chip8& chip8, std::uint16_t address)
+{
+    if (blocks[address])
+    {
+        return *blocks[address];
+    }
+
+    blocks[address].reset(new Block());
+    Block& block = *blocks[address];
+    block.start = address;
+    while (address + 1 < MEMORY_SIZE && block.ops.size() < MAX_BLOCK_LENGTH)
+    {
+        Instruction instruction = decode(chip8.memory.readOpcode(address));
+        block.ops.push_back({ microHandlers[static_cast<int>(instruction.op)], instruction });
+        address += 2;
+        if (endsBlock(instruction.op))
+        {
+            break;
+        }
+    }
+    block.end = address;
+
+    for (int i = block.start; i < block.end; ++i)
+    {
+        ++coverage[i];
+    }
+    return block;
+}
@@ -0,0 +1,66 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include "Instruction.h"
+#include "Quirks.h"
+
+class Chip8;
+
+// Translates straight-line runs of instructions into arrays of micro-ops
+// bound to their handlers, cached by start address. A block ends at the
+// first instruction that can change control flow.
+class BlockCache
+{
+public:
+    void run(Chip8& chip8, int cycles);
+    void invalidate(std::uint16_t address);
+    void clear();
+    void setQuirks(const Quirks& quirks);
+
+private:
+    typedef void (*MicroHandler)(Chip8& chip8, const Instruction& in);
+
+    struct MicroOp
+    {
+        MicroHandler handler;
+        Instruction instruction;
+    };
+
+    struct Block
+    {
+        std::uint16_t start;
+        std::uint16_t end;
+        std::vector<MicroOp> ops;
+    };
+
+    const Block& lookup(Chip8& chip8, std::uint16_t address);
+    void erase(int start);
+
+    template <void (Chip8::*Handler)(const Instruction&)>
+    static void bind(Chip8& chip8, const Instruction& in);
+
+    template <class Q>
+    struct MicroHandlers
+    {
+        static const MicroHandler TABLE[static_cast<int>(Op::Count)];
+    };
+
+    struct MicroHandlerFactory
+    {
+        typedef const MicroHandler* Result;
+
+        template <class Q>
+        static Result create() { return MicroHandlers<Q>::TABLE; }
+    };
+
+    static const int MEMORY_SIZE = 4096;
+    static const int MAX_BLOCK_LENGTH = 64;
+
+    // Indexed by start address; coverage counts how many blocks span a byte
+    std::unique_ptr<Block> blocks[MEMORY_SIZE];
+    std::uint8_t coverage[MEMORY_SIZE] = {};
+    unsigned int generation = 0;
+    const MicroHandler* microHandlers = nullptr;
+};
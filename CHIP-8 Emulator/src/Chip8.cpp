@@ -1,6 +1,12 @@
-#include "Chip8.h"
+#include "Chip8.h"
+#include "NativeProgram.h"
+#include "ExecutionProfile.h"
+#include "Movie.h"
+#include <algorithm>
+#include <climits>
+#include <cstring>
+#include <fstream>
 #include <iostream>
-#include <cstdlib>
 
 const std::uint8_t Chip8::FONTSET[FONTSET_SIZE] =
 {
@@ -22,52 +28,97 @@ const std::uint8_t Chip8::FONTSET[FONTSET_SIZE] =
     0xF0, 0x80, 0xF0, 0x80, 0x80  // F
 };
 
-Chip8::Chip8()
+const Instruction Chip8::UNDECODED_PAGE[DECODED_PAGE_SIZE] = {};
+
+Chip8::Chip8(Dispatch dispatch) :
+    dispatch(dispatch)
 {
+    createEngine();
     init();
 }
 
-Chip8::Chip8(const char* programPath)
+Chip8::Chip8(const char* programPath, Dispatch dispatch) :
+    dispatch(dispatch)
 {
+    createEngine();
     init();
     loadProgram(programPath);
 }
 
+Chip8::~Chip8()
+{
+}
+
+void Chip8::createEngine()
+{
+    if (dispatch == Dispatch::Table || dispatch == Dispatch::Threaded)
+    {
+        decodedFlat.reset(new Instruction[MEMORY_SIZE]);
+    }
+    if (dispatch == Dispatch::Block)
+    {
+        blockCache.reset(new BlockCache());
+    }
+#if CHIP8_JIT
+    if (dispatch == Dispatch::Jit)
+    {
+        jit.reset(new Jit(*this));
+    }
+#endif
+    setQuirks(quirks);
+}
+
 void Chip8::init()
 {
     reset();
-    display.init();
+}
+
+const std::shared_ptr<const MemoryImage>& Chip8::clearedImage()
+{
+    static const std::shared_ptr<const MemoryImage> image = []()
+    {
+        std::uint8_t bytes[MEMORY_SIZE] = {};
+        std::copy(FONTSET, FONTSET + FONTSET_SIZE, bytes);
+        return PagedMemory::intern(bytes);
+    }();
+    return image;
 }
 
 void Chip8::reset()
 {
-    // Clear registers
-    I = 0;
+    // Clear registers, call stack and timers
+    state.I = 0;
+    state.pc = PROGRAM_START;
     for (int i = 0; i < REGISTER_COUNT; ++i)
     {
-        V[i] = 0;
+        state.V[i] = 0;
     }
-
-    // Clear memory
-    for (int i = 0; i < MEMORY_SIZE; ++i)
+    state.sp = 0;
+    for (int i = 0; i < STACK_SIZE; ++i)
     {
-        memory[i] = 0;
+        state.stack[i] = 0;
     }
+    state.delayTimer = 0;
+    state.soundTimer = 0;
 
     // Clear display
-    display.clear();
+    state.display.clear();
 
     // Clear keypad state
-    keypad.reset();
+    state.keypad.reset();
 
-    // Load fontset
-    for (int i = 0; i < FONTSET_SIZE; ++i)
-    {
-        memory[i] = FONTSET[i];
-    }
+    // Clear memory and load fontset; machines share this image until they
+    // write to it
+    memory.setImage(clearedImage());
+
+    // Drop decoded instructions
+    invalidateAllDecoded();
+
+    // Restart emulated time
+    scheduler.reset();
 
-    // Seed random number generator
-    srand(time(NULL));
+    // Restart the random sequence
+    state.random.seed(randomSeed);
 
     // Clear screen
     shouldRedraw = true;
@@ -75,327 +126,858 @@ void Chip8::reset()
 
 void Chip8::loadProgram(const char* path)
 {
-    FILE* program;
-    fopen_s(&program, path, "rb");
-    if (program == NULL)
+    std::ifstream program(path, std::ios::binary);
+    if (!program)
     {
         std::cerr << "Unable to open program: " << path << ".\n";
         return;
     }
-    fread(&memory[PROGRAM_START], 1, MAX_PROGRAM_SIZE, program);
-    fclose(program);
-    pc = PROGRAM_START;
+    // Instances loading the same program end up sharing one image
+    std::uint8_t image[MEMORY_SIZE];
+    memory.copyTo(image);
+    program.read(reinterpret_cast<char*>(&image[PROGRAM_START]), MAX_PROGRAM_SIZE);
+    memory.setImage(PagedMemory::intern(image));
+    setQuirks(Quirks::forProgram(path));
+    state.pc = PROGRAM_START;
 }
 
 void Chip8::incrementPC()
 {
-    pc += 2;
-}
-
-void Chip8::drawSprite(std::uint8_t Vx, std::uint8_t Vy, std::uint8_t n)
-{
-    uint8_t pixel;
-    V[0xF] = 0;
-    for (int yline = 0; yline < n; yline++)
-    {
-        pixel = memory[I + yline];
-        for (int xline = 0; xline < 8; xline++)
-        {
-            if (0 != (pixel & (0x80 >> xline)))
-            {
-                int x = Vx + xline;
-                int y = Vy + yline;
-                if (display.get(x, y) == Pixel::White)
-                {
-                    V[0xF] = 1;
-                    display.set(x, y, Pixel::Black);
-                }
-                else
-                {
-                    display.set(x, y, Pixel::White);
-                }
-            }
-        }
-    }
-    shouldRedraw = true;
+    state.pc += 2;
 }
 
-void Chip8::executeOpcode()
-{
-    std::uint16_t opcode = memory[pc] << 8 | memory[pc + 1];
-    std::uint8_t x = opcode >> 8 & 0x000F;
-    std::uint8_t y = opcode >> 4 & 0x000F;
-    std::uint8_t n = opcode & 0x000F;
-    std::uint8_t kk = opcode & 0x00FF;
-    std::uint16_t nnn = opcode & 0x0FFF;
-
-    switch (opcode & 0xF000)
-    {
-    case 0x0000:
-        switch (opcode) {
-        case 0x00E0:
-            display.clear();
-            incrementPC();
-            break;
-        case 0x00EE:
-            pc = callStack.top();
-            callStack.pop();
-            incrementPC();
-            break;
-        default:
-            break;
-        }
-        break;
-    case 0x1000:
-        pc = nnn;
-        break;
-    case 0x2000:
-        callStack.push(pc);
-        pc = nnn;
-        break;
-    case 0x3000:
-        if (V[x] == kk)
+void Chip8::writeMemory(std::uint16_t address, std::uint8_t value)
+{
+    // I can point past the end of memory; stores wrap like loads do
+    address &= MEMORY_SIZE - 1;
+    memory.write(address, value);
+    invalidateDecoded(address);
+}
+
+void Chip8::invalidateDecoded(std::uint16_t address)
+{
+    // An instruction starting one byte earlier also covers this address, and
+    // a superinstruction covers every byte of the opcodes it fused. The
+    // opcode at the last address reads its second byte from address 0.
+    for (int i = 0; i < 2 * MAX_FUSION_LENGTH; ++i)
+    {
+        const int start = (address - i) & (MEMORY_SIZE - 1);
+        const int page = start / DECODED_PAGE_SIZE;
+        if (decodedFlat)
         {
-            incrementPC();
+            decodedFlat[start].op = Op::Undecoded;
         }
-        incrementPC();
-        break;
-    case 0x4000:
-        if (V[x] != kk)
+        else if (decodedStorage[page])
         {
-            incrementPC();
+            decodedStorage[page][start % DECODED_PAGE_SIZE].op = Op::Undecoded;
         }
-        incrementPC();
-        break;
-    case 0x5000:
-        if (V[x] == V[y])
+    }
+    if (native)
+    {
+        native->invalidate(address);
+    }
+    if (blockCache)
+    {
+        blockCache->invalidate(address);
+    }
+#if CHIP8_JIT
+    if (jit)
+    {
+        jit->invalidate(address);
+    }
+#endif
+}
+
+void Chip8::invalidateAllDecoded()
+{
+    if (decodedFlat)
+    {
+        std::fill(decodedFlat.get(), decodedFlat.get() + MEMORY_SIZE, Instruction());
+    }
+    for (int page = 0; page < PagedMemory::PAGE_COUNT; ++page)
+    {
+        decodedPages[page] = decodedFlat ? &decodedFlat[page * DECODED_PAGE_SIZE] : UNDECODED_PAGE;
+        decodedStorage[page].reset();
+    }
+    if (native)
+    {
+        native->clear();
+    }
+    if (blockCache)
+    {
+        blockCache->clear();
+    }
+#if CHIP8_JIT
+    if (jit)
+    {
+        jit->clear();
+    }
+#endif
+}
+
+// Jumps and skips can take pc past the end of memory; fetches wrap like
+// every other access, while pc itself keeps counting
+const Instruction& Chip8::decodeAt(std::uint16_t address)
+{
+    const int page = address / DECODED_PAGE_SIZE;
+    if (!decodedFlat && !decodedStorage[page])
+    {
+        decodedStorage[page].reset(new Instruction[DECODED_PAGE_SIZE]);
+        decodedPages[page] = decodedStorage[page].get();
+    }
+    Instruction& instruction = decodedFlat ? decodedFlat[address] : decodedStorage[page][address % DECODED_PAGE_SIZE];
+    instruction = decode(memory.readOpcode(address));
+    // Profiles must see the individual opcodes
+    if (profile == nullptr)
+    {
+        instruction.op = fuse(address, instruction.op);
+    }
+    return instruction;
+}
+
+Op Chip8::fuse(std::uint16_t address, Op op) const
+{
+    // The generated table lists longer sequences first, so the first match
+    // is the longest
+    for (int i = 0; i < FUSION_COUNT; ++i)
+    {
+        const Fusion& fusion = FUSIONS[i];
+        if (fusion.ops[0] != op)
         {
-            incrementPC();
+            continue;
         }
-        incrementPC();
-        break;
-    case 0x6000:
-        V[x] = kk;
-        incrementPC();
-        break;
-    case 0x7000:
-        V[x] += kk;
-        incrementPC();
-        break;
-    case 0x8000:
-        switch (opcode & 0x000F) {
-        case 0x0000:
-            V[x] = V[y];
-            incrementPC();
-            break;
-        case 0x0001:
-            V[x] |= V[y];
-            incrementPC();
-            break;
-        case 0x0002:
-            V[x] &= V[y];
-            incrementPC();
-            break;
-        case 0x0003:
-            V[x] ^= V[y];
-            incrementPC();
-            break;
-        case 0x0004:
-            if (V[y] > (0xFF - V[x]))
-            {
-                V[0xF] = 1;
-            }
-            else
-            {
-                V[0xF] = 0;
-            }
-            V[x] += V[y];
-            incrementPC();
-            break;
-        case 0x0005:
-            if (V[y] > V[x])
-            {
-                V[0xF] = 0;
-            }
-            else
-            {
-                V[0xF] = 1;
-            }
-            V[x] -= V[y];
-            incrementPC();
-            break;
-        case 0x0006:
-            V[0xF] = V[x] & 0x1;
-            V[x] >>= 1;
-            incrementPC();
-            break;
-        case 0x0007:
-            if (V[x] > V[y])
-            {
-                V[0xF] = 0;
-            }
-            else
-            {
-                V[0xF] = 1;
-            }
-            V[x] = V[y] - V[x];
-            incrementPC();
-            break;
-        case 0x000E:
-            V[0xF] = V[x] >> 7;
-            V[x] <<= 1;
-            incrementPC();
-            break;
-        default:
-            break;
+
+        bool matches = true;
+        for (int j = 1; j < fusion.length && matches; ++j)
+        {
+            int next = address + 2 * j;
+            matches = next + 1 < MEMORY_SIZE && decode(memory.readOpcode(next)).op == fusion.ops[j];
         }
-        break;
-    case 0x9000:
-        if (V[x] != V[y])
+        if (matches)
         {
-            incrementPC();
+            return static_cast<Op>(static_cast<int>(Op::Count) + i);
         }
+    }
+    return op;
+}
+
+template <class Q>
+const Chip8::Handler Chip8::Policy<Q>::HANDLERS[static_cast<int>(Op::Count)] =
+{
+    &Chip8::opInvalid,      // Undecoded
+    &Chip8::opInvalid,      // Invalid
+    &Chip8::opCls,
+    &Chip8::opRet,
+    &Chip8::opJp,
+    &Chip8::opCall,
+    &Chip8::opSeVxByte,
+    &Chip8::opSneVxByte,
+    &Chip8::opSeVxVy,
+    &Chip8::opLdVxByte,
+    &Chip8::opAddVxByte,
+    &Chip8::opLdVxVy,
+    &Chip8::opOrVxVy<Q>,
+    &Chip8::opAndVxVy<Q>,
+    &Chip8::opXorVxVy<Q>,
+    &Chip8::opAddVxVy,
+    &Chip8::opSubVxVy,
+    &Chip8::opShrVx<Q>,
+    &Chip8::opSubnVxVy,
+    &Chip8::opShlVx<Q>,
+    &Chip8::opSneVxVy,
+    &Chip8::opLdI,
+    &Chip8::opJpV0<Q>,
+    &Chip8::opRnd,
+    &Chip8::opDrw<Q>,
+    &Chip8::opSkp,
+    &Chip8::opSknp,
+    &Chip8::opLdVxDt,
+    &Chip8::opLdVxK,
+    &Chip8::opLdDtVx,
+    &Chip8::opLdStVx,
+    &Chip8::opAddIVx,
+    &Chip8::opLdFVx,
+    &Chip8::opLdBVx,
+    &Chip8::opLdIVx<Q>,
+    &Chip8::opLdVxI<Q>
+};
+
+template <class Q>
+const Chip8::Core Chip8::Policy<Q>::CORE =
+{
+    &Chip8::interpret<Q>,
+    &Chip8::executeOpcode<Q>,
+    Policy<Q>::HANDLERS
+};
+
+// Each opcode after the first starts at the address its predecessor left in
+// pc, just as it would after a separate dispatch.
+template <Chip8::Handler Last>
+void Chip8::opSequence(const Instruction& in)
+{
+    (this->*Last)(in);
+}
+
+template <Chip8::Handler First, Chip8::Handler Second, Chip8::Handler... Rest>
+void Chip8::opSequence(const Instruction& in)
+{
+    (this->*First)(in);
+    opSequence<Second, Rest...>(fetch());
+}
+
+#include "Superinstructions.inc"
+
+int Chip8::executeOpcode(int budget)
+{
+    return (this->*core->executeOpcode)(budget);
+}
+
+// Returns the number of instructions retired, which is more than one when a
+// superinstruction fits in the budget.
+template <class Q>
+int Chip8::executeOpcode(int budget)
+{
+    return executeInstruction<Q>(fetch(), budget);
+}
+
+template <class Q>
+int Chip8::executeInstruction(const Instruction& instruction, int budget)
+{
+    if (profile)
+    {
+        profile->record(state.pc, instruction.op);
+    }
+    if (instruction.op >= Op::Count)
+    {
+        return executeFused<Q>(instruction, budget);
+    }
+    if (dispatch == Dispatch::Table)
+    {
+        (this->*Policy<Q>::HANDLERS[static_cast<int>(instruction.op)])(instruction);
+        return 1;
+    }
+
+    switch (instruction.op)
+    {
+    case Op::Cls: opCls(instruction); break;
+    case Op::Ret: opRet(instruction); break;
+    case Op::Jp: opJp(instruction); break;
+    case Op::Call: opCall(instruction); break;
+    case Op::SeVxByte: opSeVxByte(instruction); break;
+    case Op::SneVxByte: opSneVxByte(instruction); break;
+    case Op::SeVxVy: opSeVxVy(instruction); break;
+    case Op::LdVxByte: opLdVxByte(instruction); break;
+    case Op::AddVxByte: opAddVxByte(instruction); break;
+    case Op::LdVxVy: opLdVxVy(instruction); break;
+    case Op::OrVxVy: opOrVxVy<Q>(instruction); break;
+    case Op::AndVxVy: opAndVxVy<Q>(instruction); break;
+    case Op::XorVxVy: opXorVxVy<Q>(instruction); break;
+    case Op::AddVxVy: opAddVxVy(instruction); break;
+    case Op::SubVxVy: opSubVxVy(instruction); break;
+    case Op::ShrVx: opShrVx<Q>(instruction); break;
+    case Op::SubnVxVy: opSubnVxVy(instruction); break;
+    case Op::ShlVx: opShlVx<Q>(instruction); break;
+    case Op::SneVxVy: opSneVxVy(instruction); break;
+    case Op::LdI: opLdI(instruction); break;
+    case Op::JpV0: opJpV0<Q>(instruction); break;
+    case Op::Rnd: opRnd(instruction); break;
+    case Op::Drw: opDrw<Q>(instruction); break;
+    case Op::Skp: opSkp(instruction); break;
+    case Op::Sknp: opSknp(instruction); break;
+    case Op::LdVxDt: opLdVxDt(instruction); break;
+    case Op::LdVxK: opLdVxK(instruction); break;
+    case Op::LdDtVx: opLdDtVx(instruction); break;
+    case Op::LdStVx: opLdStVx(instruction); break;
+    case Op::AddIVx: opAddIVx(instruction); break;
+    case Op::LdFVx: opLdFVx(instruction); break;
+    case Op::LdBVx: opLdBVx(instruction); break;
+    case Op::LdIVx: opLdIVx<Q>(instruction); break;
+    case Op::LdVxI: opLdVxI<Q>(instruction); break;
+    default: opInvalid(instruction); break;
+    }
+    return 1;
+}
+
+template <class Q>
+int Chip8::executeFused(const Instruction& in, int budget)
+{
+    static_assert(sizeof(FUSIONS) / sizeof(FUSIONS[0]) <= MAX_FUSIONS, "Too many superinstructions");
+
+    const int index = static_cast<int>(in.op) - static_cast<int>(Op::Count);
+    const Fusion& fusion = FUSIONS[index];
+    if (budget < fusion.length)
+    {
+        // Not enough cycles left for the whole sequence
+        (this->*Policy<Q>::HANDLERS[static_cast<int>(fusion.ops[0])])(in);
+        return 1;
+    }
+    (this->*Policy<Q>::FUSED_HANDLERS[index])(in);
+    return fusion.length;
+}
+
+void Chip8::opInvalid(const Instruction&)
+{
+}
+
+void Chip8::opCls(const Instruction&)
+{
+    state.display.clear();
+    incrementPC();
+}
+
+void Chip8::opRet(const Instruction&)
+{
+    state.sp = (state.sp - 1) & (STACK_SIZE - 1);
+    state.pc = state.stack[state.sp];
+    incrementPC();
+}
+
+void Chip8::opJp(const Instruction& in)
+{
+    state.pc = in.nnn();
+}
+
+void Chip8::opCall(const Instruction& in)
+{
+    state.stack[state.sp] = state.pc;
+    state.sp = (state.sp + 1) & (STACK_SIZE - 1);
+    state.pc = in.nnn();
+}
+
+void Chip8::opSeVxByte(const Instruction& in)
+{
+    if (state.V[in.x] == in.kk)
+    {
         incrementPC();
-        break;
-    case 0xA000:
-        I = nnn;
+    }
+    incrementPC();
+}
+
+void Chip8::opSneVxByte(const Instruction& in)
+{
+    if (state.V[in.x] != in.kk)
+    {
         incrementPC();
-        break;
-    case 0xB000:
-        pc = nnn + V[0];
-        break;
-    case 0xC000:
-        V[x] = (rand() % 0xFF) & kk;
+    }
+    incrementPC();
+}
+
+void Chip8::opSeVxVy(const Instruction& in)
+{
+    if (state.V[in.x] == state.V[in.y])
+    {
         incrementPC();
-        break;
-    case 0xD000:
-        drawSprite(V[x], V[y], n);
+    }
+    incrementPC();
+}
+
+void Chip8::opLdVxByte(const Instruction& in)
+{
+    state.V[in.x] = in.kk;
+    incrementPC();
+}
+
+void Chip8::opAddVxByte(const Instruction& in)
+{
+    state.V[in.x] += in.kk;
+    incrementPC();
+}
+
+void Chip8::opLdVxVy(const Instruction& in)
+{
+    state.V[in.x] = state.V[in.y];
+    incrementPC();
+}
+
+void Chip8::opAddVxVy(const Instruction& in)
+{
+    if (state.V[in.y] > (0xFF - state.V[in.x]))
+    {
+        state.V[0xF] = 1;
+    }
+    else
+    {
+        state.V[0xF] = 0;
+    }
+    state.V[in.x] += state.V[in.y];
+    incrementPC();
+}
+
+void Chip8::opSubVxVy(const Instruction& in)
+{
+    if (state.V[in.y] > state.V[in.x])
+    {
+        state.V[0xF] = 0;
+    }
+    else
+    {
+        state.V[0xF] = 1;
+    }
+    state.V[in.x] -= state.V[in.y];
+    incrementPC();
+}
+
+void Chip8::opSubnVxVy(const Instruction& in)
+{
+    if (state.V[in.x] > state.V[in.y])
+    {
+        state.V[0xF] = 0;
+    }
+    else
+    {
+        state.V[0xF] = 1;
+    }
+    state.V[in.x] = state.V[in.y] - state.V[in.x];
+    incrementPC();
+}
+
+void Chip8::opSneVxVy(const Instruction& in)
+{
+    if (state.V[in.x] != state.V[in.y])
+    {
         incrementPC();
-        break;
-    case 0xE000:
-        switch (opcode & 0x00FF) {
-        case 0x009E:
-            if (keypad.isKeyPressed(V[x]))
-            {
-                incrementPC();
-            }
-            incrementPC();
-            break;
-        case 0x00A1:
-            if (!keypad.isKeyPressed(V[x]))
-            {
-                incrementPC();
-            }
-            incrementPC();
-            break;
-        default:
-            break;
-        }
-        break;
-    case 0xF000:
-        switch (opcode & 0x00FF)
-        {
-        case 0x0007:
-            V[x] = delayTimer;
-            incrementPC();
-            break;
-        case 0x000A:
+    }
+    incrementPC();
+}
+
+void Chip8::opLdI(const Instruction& in)
+{
+    state.I = in.nnn();
+    incrementPC();
+}
+
+void Chip8::opRnd(const Instruction& in)
+{
+    state.V[in.x] = state.random.nextByte() & in.kk;
+    incrementPC();
+}
+
+void Chip8::opSkp(const Instruction& in)
+{
+    if (state.keypad.isKeyPressed(state.V[in.x]))
+    {
+        incrementPC();
+    }
+    incrementPC();
+}
+
+void Chip8::opSknp(const Instruction& in)
+{
+    if (!state.keypad.isKeyPressed(state.V[in.x]))
+    {
+        incrementPC();
+    }
+    incrementPC();
+}
+
+void Chip8::opLdVxDt(const Instruction& in)
+{
+    state.V[in.x] = state.delayTimer;
+    incrementPC();
+}
+
+void Chip8::opLdVxK(const Instruction& in)
+{
+    int key = state.keypad.getKey();
+    if (key == -1)
+    {
+        return;
+    }
+    state.V[in.x] = key;
+    incrementPC();
+}
+
+void Chip8::opLdDtVx(const Instruction& in)
+{
+    state.delayTimer = state.V[in.x];
+    incrementPC();
+}
+
+void Chip8::opLdStVx(const Instruction& in)
+{
+    state.soundTimer = state.V[in.x];
+    incrementPC();
+}
+
+void Chip8::opAddIVx(const Instruction& in)
+{
+    if (state.I + state.V[in.x] > 0xFFF)
+    {
+        state.V[0xF] = 1;
+    }
+    else
+    {
+        state.V[0xF] = 0;
+    }
+    state.I += state.V[in.x];
+    incrementPC();
+}
+
+void Chip8::opLdFVx(const Instruction& in)
+{
+    state.I = state.V[in.x] * 0x5;
+    incrementPC();
+}
+
+void Chip8::opLdBVx(const Instruction& in)
+{
+    writeMemory(state.I, state.V[in.x] / 100);
+    writeMemory(state.I + 1, (state.V[in.x] / 10) % 10);
+    writeMemory(state.I + 2, (state.V[in.x] % 100) % 10);
+    incrementPC();
+}
+
+void Chip8::execute(int cycles)
+{
+    if (native)
+    {
+        native->run(*this, cycles);
+        return;
+    }
+    if (blockCache)
+    {
+        blockCache->run(*this, cycles);
+        return;
+    }
+#if CHIP8_JIT
+    if (jit && jitEnabled)
+    {
+        jit->run(*this, cycles);
+        return;
+    }
+#endif
+    (this->*core->interpret)(cycles);
+}
+
+template <class Q>
+void Chip8::interpret(int cycles)
+{
+#if CHIP8_THREADED_DISPATCH
+    if (dispatch == Dispatch::Threaded)
+    {
+        executeThreaded<Q>(cycles);
+        return;
+    }
+#endif
+    if (decodedFlat)
+    {
+        const Instruction* const decoded = decodedFlat.get();
+        for (int i = 0; i < cycles;)
         {
-            int key = keypad.getKey();
-            if (key == -1)
-            {
-                return;
-            }
-            V[x] = key;
-            incrementPC();
-            break;
+            i += executeInstruction<Q>(fetchFlat(decoded), cycles - i);
         }
-        case 0x0015:
-            delayTimer = V[x];
-            incrementPC();
-            break;
-        case 0x0018:
-            soundTimer = V[x];
-            incrementPC();
-            break;
-        case 0x001E:
-            if (I + V[x] > 0xFFF)
-            {
-                V[0xF] = 1;
-            }
-            else
-            {
-                V[0xF] = 0;
-            }
-            I += V[x];
-            incrementPC();
-            break;
-        case 0x0029:
-            I = V[x] * 0x5;
-            incrementPC();
-            break;
-        case 0x0033:
-            memory[I] = V[x] / 100;
-            memory[I + 1] = (V[x] / 10) % 10;
-            memory[I + 2] = (V[x] % 100) % 10;
-            incrementPC();
-            break;
-        case 0x0055:
-            for (int i = 0; i <= x; ++i)
-            {
-                memory[I + i] = V[i];
-            }
-            I += (x + 1);
-            incrementPC();
-            break;
-        case 0x0065:
-            for (int i = 0; i <= x; ++i)
-            {
-                V[i] = memory[I + i];
-            }
-            I += (x + 1);
-            incrementPC();
-            break;
-        default:
-            break;
+        return;
+    }
+    for (int i = 0; i < cycles;)
+    {
+        i += executeOpcode<Q>(cycles - i);
+    }
+}
+
+#if CHIP8_THREADED_DISPATCH
+// Threaded interpreter: every handler ends by fetching the next instruction
+// and jumping straight to its label, so there is no central dispatch branch.
+template <class Q>
+void Chip8::executeThreaded(int cycles)
+{
+    static void* const LABELS[static_cast<int>(Op::Count) + MAX_FUSIONS] =
+    {
+        &&Invalid, &&Invalid, &&Cls, &&Ret, &&Jp, &&Call,
+        &&SeVxByte, &&SneVxByte, &&SeVxVy, &&LdVxByte, &&AddVxByte,
+        &&LdVxVy, &&OrVxVy, &&AndVxVy, &&XorVxVy, &&AddVxVy, &&SubVxVy,
+        &&ShrVx, &&SubnVxVy, &&ShlVx, &&SneVxVy, &&LdI, &&JpV0, &&Rnd,
+        &&Drw, &&Skp, &&Sknp, &&LdVxDt, &&LdVxK, &&LdDtVx, &&LdStVx,
+        &&AddIVx, &&LdFVx, &&LdBVx, &&LdIVx, &&LdVxI,
+        &&Fused, &&Fused, &&Fused, &&Fused, &&Fused, &&Fused, &&Fused, &&Fused,
+        &&Fused, &&Fused, &&Fused, &&Fused, &&Fused, &&Fused, &&Fused, &&Fused,
+        &&Fused, &&Fused, &&Fused, &&Fused, &&Fused, &&Fused, &&Fused, &&Fused,
+        &&Fused, &&Fused, &&Fused, &&Fused, &&Fused, &&Fused, &&Fused, &&Fused
+    };
+    const Instruction* const decoded = decodedFlat.get();
+    const Instruction* in;
+
+#define DISPATCH() \
+    do \
+    { \
+        if (cycles-- <= 0) \
+        { \
+            return; \
+        } \
+        in = &fetchFlat(decoded); \
+        goto *LABELS[static_cast<int>(in->op)]; \
+    } while (0)
+#define NEXT() DISPATCH()
+
+    DISPATCH();
+
+Invalid:    opInvalid(*in);    NEXT();
+Cls:        opCls(*in);        NEXT();
+Ret:        opRet(*in);        NEXT();
+Jp:         opJp(*in);         NEXT();
+Call:       opCall(*in);       NEXT();
+SeVxByte:   opSeVxByte(*in);   NEXT();
+SneVxByte:  opSneVxByte(*in);  NEXT();
+SeVxVy:     opSeVxVy(*in);     NEXT();
+LdVxByte:   opLdVxByte(*in);   NEXT();
+AddVxByte:  opAddVxByte(*in);  NEXT();
+LdVxVy:     opLdVxVy(*in);     NEXT();
+OrVxVy:     opOrVxVy<Q>(*in);  NEXT();
+AndVxVy:    opAndVxVy<Q>(*in); NEXT();
+XorVxVy:    opXorVxVy<Q>(*in); NEXT();
+AddVxVy:    opAddVxVy(*in);    NEXT();
+SubVxVy:    opSubVxVy(*in);    NEXT();
+ShrVx:      opShrVx<Q>(*in);   NEXT();
+SubnVxVy:   opSubnVxVy(*in);   NEXT();
+ShlVx:      opShlVx<Q>(*in);   NEXT();
+SneVxVy:    opSneVxVy(*in);    NEXT();
+LdI:        opLdI(*in);        NEXT();
+JpV0:       opJpV0<Q>(*in);    NEXT();
+Rnd:        opRnd(*in);        NEXT();
+Drw:        opDrw<Q>(*in);     NEXT();
+Skp:        opSkp(*in);        NEXT();
+Sknp:       opSknp(*in);       NEXT();
+LdVxDt:     opLdVxDt(*in);     NEXT();
+LdVxK:      opLdVxK(*in);      NEXT();
+LdDtVx:     opLdDtVx(*in);     NEXT();
+LdStVx:     opLdStVx(*in);     NEXT();
+AddIVx:     opAddIVx(*in);     NEXT();
+LdFVx:      opLdFVx(*in);      NEXT();
+LdBVx:      opLdBVx(*in);      NEXT();
+LdIVx:      opLdIVx<Q>(*in);   NEXT();
+LdVxI:      opLdVxI<Q>(*in);   NEXT();
+// DISPATCH already counted the first opcode of the sequence
+Fused:      cycles -= executeFused<Q>(*in, cycles + 1) - 1; NEXT();
+
+#undef NEXT
+#undef DISPATCH
+}
+#endif
+
+// Runs a budget of instructions. Returns true if the framebuffer changed
+// since the previous run, so the host knows when to present it.
+bool Chip8::run(int cycles)
+{
+    // Engines run uninterrupted up to the next timer event
+    while (cycles > 0)
+    {
+        const int slice = scheduler.cyclesUntilTimer(cycles);
+        execute(slice);
+        cycles -= slice;
+        for (int ticks = scheduler.advance(slice); ticks > 0; --ticks)
+        {
+            updateTimers();
         }
-        break;
-    default:
-        break;
     }
+    const bool changed = shouldRedraw;
+    shouldRedraw = false;
+    return changed;
 }
 
-void Chip8::update()
+// Runs one 60 Hz timer period of emulated time, cut short if the budget of
+// instructions runs out first
+bool Chip8::runFrame(int budget)
 {
-    executeOpcode();
+    if (!scheduler.isUnlimited())
+    {
+        return run(scheduler.cyclesUntilTimer(budget));
+    }
+
+    const bool changed = run(budget < Scheduler::UNLIMITED_FRAME_CYCLES ? budget : Scheduler::UNLIMITED_FRAME_CYCLES);
     updateTimers();
+    return changed;
+}
+
+const Display& Chip8::getDisplay() const
+{
+    return state.display;
+}
+
+std::uint32_t Chip8::takeDirtyRows()
+{
+    const std::uint32_t rows = state.display.getDirtyRows();
+    state.display.clearDirtyRows();
+    return rows;
+}
+
+std::uint64_t Chip8::getCycles() const
+{
+    return scheduler.getCycles();
+}
+
+std::uint64_t Chip8::getStateHash() const
+{
+    return hashState(state, memory.getHash());
+}
+
+std::uint64_t Chip8::hashSnapshot(const Snapshot& snapshot)
+{
+    std::uint64_t memoryHash = 0;
+    for (int address = 0; address < MEMORY_SIZE; ++address)
+    {
+        memoryHash += memoryHashTerm(address, snapshot.memory[address]);
+    }
+    MachineState state = snapshot.machine;
+    state.display = Display();
+    for (int y = 0; y < Display::HEIGHT; ++y)
+    {
+        state.display.setRow(y, snapshot.machine.display.getRow(y));
+    }
+    return hashState(state, memoryHash);
+}
+
+std::uint64_t Chip8::hashState(const MachineState& state, std::uint64_t memoryHash)
+{
+    // The keypad is input rather than state and is left out
+    static_assert(sizeof(state.V) == 2 * sizeof(std::uint64_t) && sizeof(state.stack) == 4 * sizeof(std::uint64_t),
+        "Registers are hashed a word at a time");
+    std::uint64_t words[8];
+    std::memcpy(&words[0], state.V, sizeof(state.V));
+    std::memcpy(&words[2], state.stack, sizeof(state.stack));
+    words[6] = static_cast<std::uint64_t>(state.I) | static_cast<std::uint64_t>(state.pc) << 16 |
+        static_cast<std::uint64_t>(state.sp) << 32 | static_cast<std::uint64_t>(state.delayTimer) << 40 |
+        static_cast<std::uint64_t>(state.soundTimer) << 48;
+    words[7] = state.random.state;
 
-    if (shouldRedraw)
+    std::uint64_t hash = memoryHash ^ mixHash(state.display.getHash());
+    for (std::uint64_t word : words)
     {
-        display.update();
-        shouldRedraw = false;
+        hash = mixHash(hash ^ word);
     }
-    display.render();
+    return hash;
 }
 
 void Chip8::updateTimers()
 {
-    if (delayTimer > 0)
+    if (state.delayTimer > 0)
+    {
+        --state.delayTimer;
+    }
+    updateSoundTimer();
+}
+
+void Chip8::updateSoundTimer()
+{
+    if (state.soundTimer > 0)
+    {
+        --state.soundTimer;
+    }
+}
+
+bool Chip8::isSoundOn() const
+{
+    return state.soundTimer > 0;
+}
+
+void Chip8::updateKeypad(Key key, bool isPressed)
+{
+    state.keypad.updateKey(key, isPressed);
+    if (movie)
+    {
+        movie->recordKeys(state.keypad.getKeys());
+    }
+}
+
+// Sets every CHIP-8 key at once, bit i being key i
+void Chip8::setKeys(std::uint16_t keys)
+{
+    state.keypad.setKeys(keys);
+    if (movie)
+    {
+        movie->recordKeys(keys);
+    }
+}
+
+std::uint16_t Chip8::getKeys() const
+{
+    return state.keypad.getKeys();
+}
+
+// Reseeds the random numbers behind CXKK. The seed is kept, so reset()
+// restarts the same sequence.
+void Chip8::seed(std::uint64_t seed)
+{
+    randomSeed = seed;
+    state.random.seed(seed);
+}
+
+void Chip8::setClockRate(int instructionsPerSecond)
+{
+    scheduler.setClockRate(instructionsPerSecond);
+}
+
+int Chip8::getClockRate() const
+{
+    return scheduler.getClockRate();
+}
+
+void Chip8::setJitEnabled(bool enabled)
+{
+    // Compiled blocks stay valid while disabled because stores still
+    // invalidate them, so switching back and forth is cheap.
+    jitEnabled = enabled;
+}
+
+void Chip8::setProfile(ExecutionProfile* profile)
+{
+    // Superinstructions are decoded only while no profile is attached
+    this->profile = profile;
+    invalidateAllDecoded();
+}
+
+void Chip8::setMovie(Movie* movie)
+{
+    this->movie = movie;
+}
+
+const Quirks& Chip8::getQuirks() const
+{
+    return quirks;
+}
+
+void Chip8::setQuirks(const Quirks& quirks)
+{
+    this->quirks = quirks;
+    core = selectQuirkPolicy<CoreFactory>(quirks);
+    if (blockCache)
     {
-        --delayTimer;
+        blockCache->setQuirks(quirks);
     }
+    // Translated code was specialized for the previous quirks
+    invalidateAllDecoded();
+}
+
+void Chip8::snapshot(Snapshot& out) const
+{
+    out.machine = state;
+    // Dirty rows belong to the presenter, not to the machine
+    out.machine.display.clearDirtyRows();
+    out.scheduler = scheduler;
+    memory.copyTo(out.memory);
+}
 
-    if (soundTimer > 0)
+void Chip8::restore(const Snapshot& in)
+{
+    state = in.machine;
+    state.display.markAllRowsDirty();
+    scheduler = in.scheduler;
+    for (int page = 0; page < PagedMemory::PAGE_COUNT; ++page)
     {
-        if (soundTimer == 1)
+        const int start = page * PagedMemory::PAGE_SIZE;
+        if (memory.pageEquals(page, &in.memory[start]))
+        {
+            continue;
+        }
+        memory.writePage(page, &in.memory[start]);
+        for (int address = start; address < start + PagedMemory::PAGE_SIZE; ++address)
         {
-            std::cout << "beep\n";
+            invalidateDecoded(address);
         }
-        --soundTimer;
     }
+    shouldRedraw = true;
 }
 
-void Chip8::updateKeypad(Key key, bool isPressed)
+void Chip8::attachNativeProgram(const NativeProgram* program)
 {
-    keypad.updateKey(key, isPressed);
+    // The program is only used while memory matches its ROM image
+    native.reset(program != nullptr ? new NativeRunner(*program) : nullptr);
 }
@@ -1,34 +1,241 @@
 #pragma once
 
+#include <climits>
 #include <cstddef>
 #include <cstdint>
-#include <stack>
+#include <memory>
 #include <unordered_map>
-#include <GL/glew.h>
-#include <GLFW/glfw3.h>
-#include "Window.h"
 #include "Display.h"
-#include "Keypad.h"
-
-class Chip8
+#include "MachineState.h"
+#include "Instruction.h"
+#include "Quirks.h"
+#include "Scheduler.h"
+#include "BlockCache.h"
+#include "Jit.h"
+
+class NativeRunner;
+struct NativeProgram;
+class ExecutionProfile;
+class Movie;
+
+// Computed goto is a GCC/Clang extension; other compilers fall back to the
+// switch when Dispatch::Threaded is requested.
+#if defined(__GNUC__) || defined(__clang__)
+#define CHIP8_THREADED_DISPATCH 1
+#else
+#define CHIP8_THREADED_DISPATCH 0
+#endif
+
+// Selects how decoded instructions are dispatched to their handlers
+enum class Dispatch
+{
+    Switch,
+    Table,
+    Threaded,
+    Block,
+    Jit,
+};
+
+// One CHIP-8 machine. An instance holds its MachineState (384 bytes), the
+// memory pages it has written (256 bytes each; the rest are shared with
+// every machine running the same program) and a 1 KB decode table per page
+// it has run code from, so an interpreted instance typically needs under
+// 8 KB. Dispatch::Table and Dispatch::Threaded decode into a flat 16 KB
+// table instead. Dispatch::Block adds 36 KB of tables plus the blocks it builds, and
+// Dispatch::Jit 68 KB of tables and a 256 KB code buffer.
+class Chip8
 {
 public:
-    Chip8();
-    Chip8(const char* programPath);
+    Chip8(Dispatch dispatch = Dispatch::Switch);
+    Chip8(const char* programPath, Dispatch dispatch = Dispatch::Switch);
+    ~Chip8();
 
     void init();
     void reset();
     void loadProgram(const char* path);
-    void update();
+    bool run(int cycles);
+    bool runFrame(int budget = INT_MAX);
+    const Display& getDisplay() const;
+    // Returns the display rows changed since the last call, bit y for row
+    // y, and starts tracking afresh
+    std::uint32_t takeDirtyRows();
+    std::uint64_t getCycles() const;
+    // The tone sounds while the sound timer runs; the host decides how to
+    // play it
+    bool isSoundOn() const;
+    // 64-bit hash of the registers, stack, timers, random generator, memory
+    // and framebuffer. Memory and framebuffer hashes are maintained as they
+    // are written, so this costs a few mixes rather than a scan.
+    std::uint64_t getStateHash() const;
+    // getStateHash of the machine a snapshot was taken from, recomputed
+    // from the memory and rows rather than the running hashes
+    static std::uint64_t hashSnapshot(const Snapshot& snapshot);
+    void setClockRate(int instructionsPerSecond);
+    int getClockRate() const;
+    const Quirks& getQuirks() const;
     void updateKeypad(Key key, bool isPressed);
+    void setKeys(std::uint16_t keys);
+    std::uint16_t getKeys() const;
+    void seed(std::uint64_t seed);
+    void setJitEnabled(bool enabled);
+    void attachNativeProgram(const NativeProgram* program);
+    void setProfile(ExecutionProfile* profile);
+    // Key changes are recorded into the movie while one is attached
+    void setMovie(Movie* movie);
+    void setQuirks(const Quirks& quirks);
+    // Copies out the whole machine, or puts it back. Restoring only drops
+    // decoded code for the memory pages that differ.
+    void snapshot(Snapshot& out) const;
+    void restore(const Snapshot& in);
 
 private:
-    void executeOpcode();
+    friend class BlockCache;
+    friend class Chip8Batch;
+#if CHIP8_JIT
+    friend class Jit;
+#endif
+    friend class NativeContext;
+    friend class NativeRunner;
+
+    void createEngine();
+    // getStateHash for a machine whose memory hashes to memoryHash
+    static std::uint64_t hashState(const MachineState& state, std::uint64_t memoryHash);
+    // Cleared memory holding the fontset, interned once and shared by every
+    // reset
+    static const std::shared_ptr<const MemoryImage>& clearedImage();
+    void execute(int cycles);
+    int executeOpcode(int budget = 1);
+    template <class Q>
+    void interpret(int cycles);
+    template <class Q>
+    int executeOpcode(int budget);
+    template <class Q>
+    int executeInstruction(const Instruction& instruction, int budget);
+    template <class Q>
+    int executeFused(const Instruction& in, int budget);
+#if CHIP8_THREADED_DISPATCH
+    template <class Q>
+    void executeThreaded(int cycles);
+#endif
+    const Instruction& fetch()
+    {
+        const std::uint16_t address = state.pc & (MEMORY_SIZE - 1);
+        const Instruction& cached = decodedPages[address / DECODED_PAGE_SIZE][address % DECODED_PAGE_SIZE];
+        return cached.op != Op::Undecoded ? cached : decodeAt(address);
+    }
+    // fetch for the Table and Threaded loops, which hold decodedFlat in a
+    // local so that a fetch is a single load
+    const Instruction& fetchFlat(const Instruction* decoded)
+    {
+        const std::uint16_t address = state.pc & (MEMORY_SIZE - 1);
+        const Instruction& cached = decoded[address];
+        return cached.op != Op::Undecoded ? cached : decodeAt(address);
+    }
+    const Instruction& decodeAt(std::uint16_t address);
+    Op fuse(std::uint16_t address, Op op) const;
+    void writeMemory(std::uint16_t address, std::uint8_t value);
+    void invalidateDecoded(std::uint16_t address);
+    void invalidateAllDecoded();
     void incrementPC();
+    template <class Q>
     void drawSprite(std::uint8_t x, std::uint8_t y, std::uint8_t n);
     void updateTimers();
+    void updateSoundTimer();
+
+    void opInvalid(const Instruction& in);
+    void opCls(const Instruction& in);
+    void opRet(const Instruction& in);
+    void opJp(const Instruction& in);
+    void opCall(const Instruction& in);
+    void opSeVxByte(const Instruction& in);
+    void opSneVxByte(const Instruction& in);
+    void opSeVxVy(const Instruction& in);
+    void opLdVxByte(const Instruction& in);
+    void opAddVxByte(const Instruction& in);
+    void opLdVxVy(const Instruction& in);
+    template <class Q>
+    void opOrVxVy(const Instruction& in);
+    template <class Q>
+    void opAndVxVy(const Instruction& in);
+    template <class Q>
+    void opXorVxVy(const Instruction& in);
+    void opAddVxVy(const Instruction& in);
+    void opSubVxVy(const Instruction& in);
+    template <class Q>
+    void opShrVx(const Instruction& in);
+    void opSubnVxVy(const Instruction& in);
+    template <class Q>
+    void opShlVx(const Instruction& in);
+    void opSneVxVy(const Instruction& in);
+    void opLdI(const Instruction& in);
+    template <class Q>
+    void opJpV0(const Instruction& in);
+    void opRnd(const Instruction& in);
+    template <class Q>
+    void opDrw(const Instruction& in);
+    void opSkp(const Instruction& in);
+    void opSknp(const Instruction& in);
+    void opLdVxDt(const Instruction& in);
+    void opLdVxK(const Instruction& in);
+    void opLdDtVx(const Instruction& in);
+    void opLdStVx(const Instruction& in);
+    void opAddIVx(const Instruction& in);
+    void opLdFVx(const Instruction& in);
+    void opLdBVx(const Instruction& in);
+    template <class Q>
+    void opLdIVx(const Instruction& in);
+    template <class Q>
+    void opLdVxI(const Instruction& in);
+
+    typedef void (Chip8::*Handler)(const Instruction& in);
+
+    // Entry points of the interpreter instantiated for one quirk policy.
+    // setQuirks picks one, so the handlers never test a quirk at run time.
+    struct Core
+    {
+        void (Chip8::*interpret)(int cycles);
+        int (Chip8::*executeOpcode)(int budget);
+        const Handler* handlers;
+    };
+
+    template <class Q>
+    struct Policy
+    {
+        static const Handler HANDLERS[static_cast<int>(Op::Count)];
+        static const Handler FUSED_HANDLERS[];
+        static const Core CORE;
+    };
 
-    static const int REGISTER_COUNT = 16;
+    struct CoreFactory
+    {
+        typedef const Core* Result;
+
+        template <class Q>
+        static Result create() { return &Policy<Q>::CORE; }
+    };
+
+    // Superinstructions: runs of opcodes that profiling showed to execute
+    // back to back, dispatched once and run through a single handler. The
+    // table is generated into Superinstructions.inc by tools/SuperinstructionGen.
+    static const int MAX_FUSION_LENGTH = 3;
+    static const int MAX_FUSIONS = 32;
+
+    struct Fusion
+    {
+        int length;
+        Op ops[MAX_FUSION_LENGTH];
+    };
+
+    static const Fusion FUSIONS[];
+    static const int FUSION_COUNT;
+
+    template <Handler Last>
+    void opSequence(const Instruction& in);
+    template <Handler First, Handler Second, Handler... Rest>
+    void opSequence(const Instruction& in);
+
+    static const int REGISTER_COUNT = MachineState::REGISTER_COUNT;
+    static const int STACK_SIZE = MachineState::STACK_SIZE;
     static const int PROGRAM_START = 512;
     static const int MEMORY_SIZE = 4096;
     static const int MAX_PROGRAM_SIZE = MEMORY_SIZE - PROGRAM_START;
@@ -36,15 +243,144 @@ private:
     static const int FONTSET_SIZE = 80;
     static const std::uint8_t FONTSET[FONTSET_SIZE];
 
+    Dispatch dispatch;
+    Quirks quirks;
+    Scheduler scheduler;
+    const Core* core = nullptr;
+    std::unique_ptr<BlockCache> blockCache;
+#if CHIP8_JIT
+    std::unique_ptr<Jit> jit;
+#endif
+    bool jitEnabled = true;
+    std::unique_ptr<NativeRunner> native;
+    ExecutionProfile* profile = nullptr;
+    Movie* movie = nullptr;
     bool shouldRedraw = false;
-    Display display;
-    Keypad keypad;
-    std::uint8_t memory[MEMORY_SIZE];
-    std::stack<std::uint16_t> callStack;
-    std::uint8_t V[REGISTER_COUNT];
-    std::uint16_t I = 0;
-    std::uint16_t pc = PROGRAM_START;
-    std::uint8_t delayTimer = 0;
-    std::uint8_t soundTimer = 0;
-};
-
+    std::uint64_t randomSeed = 0;
+    MachineState state;
+    PagedMemory memory;
+
+    // Decoded instructions, one table per page of memory. A page points at
+    // the shared UNDECODED_PAGE until code in it first runs, so machines
+    // only pay for the pages they execute.
+    static const int DECODED_PAGE_SIZE = PagedMemory::PAGE_SIZE;
+    static const Instruction UNDECODED_PAGE[DECODED_PAGE_SIZE];
+    const Instruction* decodedPages[PagedMemory::PAGE_COUNT];
+    std::unique_ptr<Instruction[]> decodedStorage[PagedMemory::PAGE_COUNT];
+    // Table and Threaded dispatch trade the saving for speed: they decode
+    // into one flat table, which decodedPages points into
+    std::unique_ptr<Instruction[]> decodedFlat;
+};
+
+// Handlers that depend on quirks are defined here so that every engine can
+// instantiate them for the policy it runs with.
+
+template <class Q>
+void Chip8::drawSprite(std::uint8_t Vx, std::uint8_t Vy, std::uint8_t n)
+{
+    // A clipped sprite still starts at its position wrapped onto the screen
+    const int left = Vx & (Display::WIDTH - 1);
+    const int top = Vy & (Display::HEIGHT - 1);
+    const int height = Display::spriteHeight<Q::spritesWrap>(top, n);
+
+    bool collided = false;
+    for (int yline = 0; yline < height; yline++)
+    {
+        const std::uint64_t mask = Display::spriteRow<Q::spritesWrap>(memory.read(state.I + yline), left);
+        collided |= state.display.xorRow((top + yline) & (Display::HEIGHT - 1), mask);
+    }
+    state.V[0xF] = collided;
+    shouldRedraw = true;
+}
+
+template <class Q>
+void Chip8::opOrVxVy(const Instruction& in)
+{
+    state.V[in.x] |= state.V[in.y];
+    if (Q::logicResetsVF)
+    {
+        state.V[0xF] = 0;
+    }
+    incrementPC();
+}
+
+template <class Q>
+void Chip8::opAndVxVy(const Instruction& in)
+{
+    state.V[in.x] &= state.V[in.y];
+    if (Q::logicResetsVF)
+    {
+        state.V[0xF] = 0;
+    }
+    incrementPC();
+}
+
+template <class Q>
+void Chip8::opXorVxVy(const Instruction& in)
+{
+    state.V[in.x] ^= state.V[in.y];
+    if (Q::logicResetsVF)
+    {
+        state.V[0xF] = 0;
+    }
+    incrementPC();
+}
+
+template <class Q>
+void Chip8::opShrVx(const Instruction& in)
+{
+    const std::uint8_t source = Q::shiftReadsVy ? in.y : in.x;
+    state.V[0xF] = state.V[source] & 0x1;
+    state.V[in.x] = state.V[source] >> 1;
+    incrementPC();
+}
+
+template <class Q>
+void Chip8::opShlVx(const Instruction& in)
+{
+    const std::uint8_t source = Q::shiftReadsVy ? in.y : in.x;
+    state.V[0xF] = state.V[source] >> 7;
+    state.V[in.x] = state.V[source] << 1;
+    incrementPC();
+}
+
+template <class Q>
+void Chip8::opJpV0(const Instruction& in)
+{
+    state.pc = in.nnn() + state.V[Q::jumpAddsVx ? in.x : 0];
+}
+
+template <class Q>
+void Chip8::opDrw(const Instruction& in)
+{
+    drawSprite<Q>(state.V[in.x], state.V[in.y], in.n());
+    incrementPC();
+}
+
+template <class Q>
+void Chip8::opLdIVx(const Instruction& in)
+{
+    for (int i = 0; i <= in.x; ++i)
+    {
+        writeMemory(state.I + i, state.V[i]);
+    }
+    if (Q::loadStoreIncrementsI)
+    {
+        state.I += (in.x + 1);
+    }
+    incrementPC();
+}
+
+template <class Q>
+void Chip8::opLdVxI(const Instruction& in)
+{
+    for (int i = 0; i <= in.x; ++i)
+    {
+        state.V[i] = memory.read(state.I + i);
+    }
+    if (Q::loadStoreIncrementsI)
+    {
+        state.I += (in.x + 1);
+    }
+    incrementPC();
+}
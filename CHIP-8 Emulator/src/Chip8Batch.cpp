@@ -0,0 +1,647 @@
+#include "Chip8Batch.h"
+#include "Chip8.h"
+#include <algorithm>
+#include <climits>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+
+Chip8Batch::Chip8Batch(int laneCount) :
+    lanes(laneCount > 0 ? laneCount : 1),
+    V(REGISTER_COUNT * lanes),
+    I(lanes),
+    pc(lanes),
+    sp(lanes),
+    stack(STACK_SIZE * lanes),
+    delayTimer(lanes),
+    soundTimer(lanes),
+    keys(lanes),
+    random(lanes),
+    seeds(lanes),
+    frame(Display::HEIGHT * lanes),
+    memory(MEMORY_SIZE * lanes),
+    written(MEMORY_SIZE),
+    decoded(MEMORY_SIZE),
+    pending(lanes),
+    mask(lanes),
+    all(lanes, 0xFF)
+{
+    setQuirks(quirks);
+    reset();
+}
+
+void Chip8Batch::reset()
+{
+    std::fill(V.begin(), V.end(), 0);
+    std::fill(I.begin(), I.end(), 0);
+    std::fill(pc.begin(), pc.end(), static_cast<std::uint16_t>(Chip8::PROGRAM_START));
+    std::fill(sp.begin(), sp.end(), 0);
+    std::fill(delayTimer.begin(), delayTimer.end(), 0);
+    std::fill(soundTimer.begin(), soundTimer.end(), 0);
+    std::fill(keys.begin(), keys.end(), 0);
+    for (int lane = 0; lane < lanes; ++lane)
+    {
+        random[lane].seed(seeds[lane]);
+    }
+    std::fill(frame.begin(), frame.end(), 0);
+
+    std::fill(memory.begin(), memory.end(), 0);
+    for (int lane = 0; lane < lanes; ++lane)
+    {
+        std::copy(Chip8::FONTSET, Chip8::FONTSET + Chip8::FONTSET_SIZE, laneMemory(lane));
+    }
+
+    std::fill(written.begin(), written.end(), 0);
+    std::fill(decoded.begin(), decoded.end(), Instruction());
+    scheduler.reset();
+}
+
+void Chip8Batch::loadProgram(const char* path)
+{
+    std::ifstream program(path, std::ios::binary);
+    if (!program)
+    {
+        std::cerr << "Unable to open program: " << path << ".\n";
+        return;
+    }
+    // Every lane gets the same program, so its bytes are shared again; the
+    // rest of memory keeps whatever each lane wrote there
+    std::uint8_t* const rom = laneMemory(0) + Chip8::PROGRAM_START;
+    program.read(reinterpret_cast<char*>(rom), Chip8::MAX_PROGRAM_SIZE);
+    const int size = static_cast<int>(program.gcount());
+    for (int lane = 1; lane < lanes; ++lane)
+    {
+        std::copy(rom, rom + size, laneMemory(lane) + Chip8::PROGRAM_START);
+    }
+    std::fill(written.begin() + Chip8::PROGRAM_START, written.begin() + Chip8::PROGRAM_START + size, 0);
+    std::fill(decoded.begin(), decoded.end(), Instruction());
+    setQuirks(Quirks::forProgram(path));
+    std::fill(pc.begin(), pc.end(), static_cast<std::uint16_t>(Chip8::PROGRAM_START));
+}
+
+void Chip8Batch::run(int cycles)
+{
+    // Same slicing as Chip8::run, shared by every lane
+    while (cycles > 0)
+    {
+        const int slice = scheduler.cyclesUntilTimer(cycles);
+        (this->*executeFunction)(slice);
+        cycles -= slice;
+        for (int ticks = scheduler.advance(slice); ticks > 0; --ticks)
+        {
+            updateTimers();
+        }
+    }
+}
+
+void Chip8Batch::runFrame()
+{
+    if (!scheduler.isUnlimited())
+    {
+        run(scheduler.cyclesUntilTimer(INT_MAX));
+        return;
+    }
+
+    run(Scheduler::UNLIMITED_FRAME_CYCLES);
+    updateTimers();
+}
+
+void Chip8Batch::setClockRate(int instructionsPerSecond)
+{
+    scheduler.setClockRate(instructionsPerSecond);
+}
+
+void Chip8Batch::setQuirks(const Quirks& quirks)
+{
+    this->quirks = quirks;
+    executeFunction = selectQuirkPolicy<ExecuteFactory>(quirks);
+}
+
+void Chip8Batch::setKey(int lane, int key, bool isPressed)
+{
+    const std::uint16_t bit = static_cast<std::uint16_t>(1 << (key & 0xF));
+    keys[lane] = isPressed ? keys[lane] | bit : keys[lane] & ~bit;
+}
+
+void Chip8Batch::seed(int lane, std::uint64_t seed)
+{
+    seeds[lane] = seed;
+    random[lane].seed(seed);
+}
+
+int Chip8Batch::getLaneCount() const
+{
+    return lanes;
+}
+
+std::uint16_t Chip8Batch::getPC(int lane) const
+{
+    return pc[lane];
+}
+
+std::uint8_t Chip8Batch::getRegister(int lane, int index) const
+{
+    return V[index * lanes + lane];
+}
+
+Pixel Chip8Batch::getPixel(int lane, int x, int y) const
+{
+    return (frame[y * lanes + lane] >> (63 - x)) & 1 ? Pixel::White : Pixel::Black;
+}
+
+void Chip8Batch::copyDisplay(int lane, Display& display) const
+{
+    // Both store pixel x of a row in bit 63 - x
+    for (int y = 0; y < Display::HEIGHT; ++y)
+    {
+        display.setRow(y, frame[y * lanes + lane]);
+    }
+}
+
+std::uint64_t Chip8Batch::getStateHash(int lane) const
+{
+    MachineState state;
+    for (int i = 0; i < REGISTER_COUNT; ++i)
+    {
+        state.V[i] = V[i * lanes + lane];
+    }
+    for (int i = 0; i < STACK_SIZE; ++i)
+    {
+        state.stack[i] = stack[i * lanes + lane];
+    }
+    state.I = I[lane];
+    state.pc = pc[lane];
+    state.sp = sp[lane];
+    state.delayTimer = delayTimer[lane];
+    state.soundTimer = soundTimer[lane];
+    state.random = random[lane];
+    copyDisplay(lane, state.display);
+
+    const std::uint8_t* data = laneMemory(lane);
+    std::uint64_t memoryHash = 0;
+    for (int address = 0; address < MEMORY_SIZE; ++address)
+    {
+        memoryHash += memoryHashTerm(address, data[address]);
+    }
+    return Chip8::hashState(state, memoryHash);
+}
+
+template <class Q>
+void Chip8Batch::execute(int cycles)
+{
+    for (int i = 0; i < cycles; ++i)
+    {
+        step<Q>();
+    }
+}
+
+// Every lane retires exactly one instruction per step. When all lanes are
+// at the same address they run as one group. Otherwise the first pending
+// lane leads a group of all pending lanes at its address; once MAX_GROUPS
+// groups ran, or when some lane modified the code at the address, lanes
+// run alone with their own decode.
+template <class Q>
+void Chip8Batch::step()
+{
+    const int count = lanes;
+    const std::uint16_t* PC = pc.data();
+    const std::uint16_t leader = PC[0];
+    unsigned int diverged = 0;
+    for (int l = 0; l < count; ++l)
+    {
+        diverged |= PC[l] ^ leader;
+    }
+
+    if (diverged == 0 && isShared(leader))
+    {
+        executeGroup<Q>(fetchShared(leader & ADDRESS_MASK), all.data(), 0, count);
+        return;
+    }
+
+    std::uint8_t* waiting = pending.data();
+    std::uint8_t* group = mask.data();
+    std::fill(waiting, waiting + count, 1);
+    int groups = 0;
+    for (int first = 0; first < count; ++first)
+    {
+        if (!waiting[first])
+        {
+            continue;
+        }
+
+        const std::uint16_t address = PC[first];
+        if (groups == MAX_GROUPS || !isShared(address))
+        {
+            waiting[first] = 0;
+            executeGroup<Q>(isShared(address) ? fetchShared(address & ADDRESS_MASK) : fetchLane(first), all.data(), first, first + 1);
+            continue;
+        }
+
+        int members = 0;
+        for (int l = first; l < count; ++l)
+        {
+            const std::uint8_t member = waiting[l] & (PC[l] == address) ? 0xFF : 0;
+            group[l] = member;
+            waiting[l] &= ~member;
+            members += member & 1;
+        }
+        executeGroup<Q>(fetchShared(address & ADDRESS_MASK), members == 1 ? all.data() : group, first, members == 1 ? first + 1 : count);
+        ++groups;
+    }
+}
+
+bool Chip8Batch::isShared(std::uint16_t address) const
+{
+    address &= ADDRESS_MASK;
+    return !written[address] && !written[(address + 1) & ADDRESS_MASK];
+}
+
+const Instruction& Chip8Batch::fetchShared(std::uint16_t address)
+{
+    Instruction& instruction = decoded[address];
+    if (instruction.op == Op::Undecoded)
+    {
+        const std::uint8_t* code = laneMemory(0);
+        instruction = decode(code[address] << 8 | code[(address + 1) & ADDRESS_MASK]);
+    }
+    return instruction;
+}
+
+Instruction Chip8Batch::fetchLane(int lane) const
+{
+    const std::uint8_t* code = laneMemory(lane);
+    const int address = pc[lane] & ADDRESS_MASK;
+    return decode(code[address] << 8 | code[(address + 1) & ADDRESS_MASK]);
+}
+
+void Chip8Batch::writeMemory(int lane, int address, std::uint8_t value)
+{
+    address &= ADDRESS_MASK;
+    laneMemory(lane)[address] = value;
+    written[address] = 1;
+}
+
+// Executes in on the lanes in [first, last) whose mask m is set. Loops
+// over the lane arrays write every lane and select the old value for lanes
+// outside the group, so they vectorize; each lane keeps the statement order
+// of the Chip8 handler, which matters when an operand is VF. State is read
+// through local pointers because byte stores could alias the members.
+template <class Q>
+void Chip8Batch::executeGroup(const Instruction& in, const std::uint8_t* m, int first, int last)
+{
+    std::uint16_t* PC = pc.data();
+    std::uint16_t* regI = I.data();
+    std::uint8_t* vx = reg(in.x);
+    std::uint8_t* vy = reg(in.y);
+    std::uint8_t* vf = reg(0xF);
+    std::uint8_t* delay = delayTimer.data();
+    std::uint8_t* sound = soundTimer.data();
+    const std::uint16_t* keyState = keys.data();
+    const std::uint8_t kk = in.kk;
+    const std::uint16_t nnn = in.nnn();
+
+    switch (in.op)
+    {
+    case Op::Cls:
+        for (int y = 0; y < Display::HEIGHT; ++y)
+        {
+            std::uint64_t* r = row(y);
+            for (int l = first; l < last; ++l)
+            {
+                r[l] = m[l] ? 0 : r[l];
+            }
+        }
+        for (int l = first; l < last; ++l)
+        {
+            PC[l] = m[l] ? PC[l] + 2 : PC[l];
+        }
+        break;
+    case Op::Ret:
+        for (int l = first; l < last; ++l)
+        {
+            if (m[l])
+            {
+                sp[l] = (sp[l] - 1) & (STACK_SIZE - 1);
+                PC[l] = stack[sp[l] * lanes + l] + 2;
+            }
+        }
+        break;
+    case Op::Jp:
+        for (int l = first; l < last; ++l)
+        {
+            PC[l] = m[l] ? nnn : PC[l];
+        }
+        break;
+    case Op::Call:
+        for (int l = first; l < last; ++l)
+        {
+            if (m[l])
+            {
+                stack[sp[l] * lanes + l] = PC[l];
+                sp[l] = (sp[l] + 1) & (STACK_SIZE - 1);
+                PC[l] = nnn;
+            }
+        }
+        break;
+    case Op::SeVxByte:
+        for (int l = first; l < last; ++l)
+        {
+            PC[l] = m[l] ? PC[l] + (vx[l] == kk ? 4 : 2) : PC[l];
+        }
+        break;
+    case Op::SneVxByte:
+        for (int l = first; l < last; ++l)
+        {
+            PC[l] = m[l] ? PC[l] + (vx[l] != kk ? 4 : 2) : PC[l];
+        }
+        break;
+    case Op::SeVxVy:
+        for (int l = first; l < last; ++l)
+        {
+            PC[l] = m[l] ? PC[l] + (vx[l] == vy[l] ? 4 : 2) : PC[l];
+        }
+        break;
+    case Op::SneVxVy:
+        for (int l = first; l < last; ++l)
+        {
+            PC[l] = m[l] ? PC[l] + (vx[l] != vy[l] ? 4 : 2) : PC[l];
+        }
+        break;
+    case Op::LdVxByte:
+        for (int l = first; l < last; ++l)
+        {
+            vx[l] = m[l] ? kk : vx[l];
+            PC[l] = m[l] ? PC[l] + 2 : PC[l];
+        }
+        break;
+    case Op::AddVxByte:
+        for (int l = first; l < last; ++l)
+        {
+            vx[l] = m[l] ? vx[l] + kk : vx[l];
+            PC[l] = m[l] ? PC[l] + 2 : PC[l];
+        }
+        break;
+    case Op::LdVxVy:
+        for (int l = first; l < last; ++l)
+        {
+            vx[l] = m[l] ? vy[l] : vx[l];
+            PC[l] = m[l] ? PC[l] + 2 : PC[l];
+        }
+        break;
+    case Op::OrVxVy:
+        for (int l = first; l < last; ++l)
+        {
+            vx[l] = m[l] ? vx[l] | vy[l] : vx[l];
+            vf[l] = m[l] && Q::logicResetsVF ? 0 : vf[l];
+            PC[l] = m[l] ? PC[l] + 2 : PC[l];
+        }
+        break;
+    case Op::AndVxVy:
+        for (int l = first; l < last; ++l)
+        {
+            vx[l] = m[l] ? vx[l] & vy[l] : vx[l];
+            vf[l] = m[l] && Q::logicResetsVF ? 0 : vf[l];
+            PC[l] = m[l] ? PC[l] + 2 : PC[l];
+        }
+        break;
+    case Op::XorVxVy:
+        for (int l = first; l < last; ++l)
+        {
+            vx[l] = m[l] ? vx[l] ^ vy[l] : vx[l];
+            vf[l] = m[l] && Q::logicResetsVF ? 0 : vf[l];
+            PC[l] = m[l] ? PC[l] + 2 : PC[l];
+        }
+        break;
+    case Op::AddVxVy:
+        for (int l = first; l < last; ++l)
+        {
+            vf[l] = m[l] ? (vy[l] > 0xFF - vx[l] ? 1 : 0) : vf[l];
+            vx[l] = m[l] ? vx[l] + vy[l] : vx[l];
+            PC[l] = m[l] ? PC[l] + 2 : PC[l];
+        }
+        break;
+    case Op::SubVxVy:
+        for (int l = first; l < last; ++l)
+        {
+            vf[l] = m[l] ? (vy[l] > vx[l] ? 0 : 1) : vf[l];
+            vx[l] = m[l] ? vx[l] - vy[l] : vx[l];
+            PC[l] = m[l] ? PC[l] + 2 : PC[l];
+        }
+        break;
+    case Op::SubnVxVy:
+        for (int l = first; l < last; ++l)
+        {
+            vf[l] = m[l] ? (vx[l] > vy[l] ? 0 : 1) : vf[l];
+            vx[l] = m[l] ? vy[l] - vx[l] : vx[l];
+            PC[l] = m[l] ? PC[l] + 2 : PC[l];
+        }
+        break;
+    case Op::ShrVx:
+    {
+        const std::uint8_t* source = Q::shiftReadsVy ? vy : vx;
+        for (int l = first; l < last; ++l)
+        {
+            vf[l] = m[l] ? source[l] & 0x1 : vf[l];
+            vx[l] = m[l] ? source[l] >> 1 : vx[l];
+            PC[l] = m[l] ? PC[l] + 2 : PC[l];
+        }
+        break;
+    }
+    case Op::ShlVx:
+    {
+        const std::uint8_t* source = Q::shiftReadsVy ? vy : vx;
+        for (int l = first; l < last; ++l)
+        {
+            vf[l] = m[l] ? source[l] >> 7 : vf[l];
+            vx[l] = m[l] ? source[l] << 1 : vx[l];
+            PC[l] = m[l] ? PC[l] + 2 : PC[l];
+        }
+        break;
+    }
+    case Op::LdI:
+        for (int l = first; l < last; ++l)
+        {
+            regI[l] = m[l] ? nnn : regI[l];
+            PC[l] = m[l] ? PC[l] + 2 : PC[l];
+        }
+        break;
+    case Op::JpV0:
+    {
+        const std::uint8_t* offset = reg(Q::jumpAddsVx ? in.x : 0);
+        for (int l = first; l < last; ++l)
+        {
+            PC[l] = m[l] ? nnn + offset[l] : PC[l];
+        }
+        break;
+    }
+    case Op::Rnd:
+        for (int l = first; l < last; ++l)
+        {
+            if (m[l])
+            {
+                vx[l] = random[l].nextByte() & kk;
+                PC[l] += 2;
+            }
+        }
+        break;
+    case Op::Drw:
+        for (int l = first; l < last; ++l)
+        {
+            if (m[l])
+            {
+                drawSprite<Q>(in, l);
+                PC[l] += 2;
+            }
+        }
+        break;
+    case Op::Skp:
+        for (int l = first; l < last; ++l)
+        {
+            const bool pressed = (keyState[l] >> (vx[l] & 0xF)) & 1;
+            PC[l] = m[l] ? PC[l] + (pressed ? 4 : 2) : PC[l];
+        }
+        break;
+    case Op::Sknp:
+        for (int l = first; l < last; ++l)
+        {
+            const bool pressed = (keyState[l] >> (vx[l] & 0xF)) & 1;
+            PC[l] = m[l] ? PC[l] + (pressed ? 2 : 4) : PC[l];
+        }
+        break;
+    case Op::LdVxDt:
+        for (int l = first; l < last; ++l)
+        {
+            vx[l] = m[l] ? delay[l] : vx[l];
+            PC[l] = m[l] ? PC[l] + 2 : PC[l];
+        }
+        break;
+    case Op::LdVxK:
+        // Waits on the instruction until a key is down, then takes the lowest
+        for (int l = first; l < last; ++l)
+        {
+            if (m[l] && keyState[l] != 0)
+            {
+                int key = 0;
+                while (!((keyState[l] >> key) & 1))
+                {
+                    ++key;
+                }
+                vx[l] = static_cast<std::uint8_t>(key);
+                PC[l] += 2;
+            }
+        }
+        break;
+    case Op::LdDtVx:
+        for (int l = first; l < last; ++l)
+        {
+            delay[l] = m[l] ? vx[l] : delay[l];
+            PC[l] = m[l] ? PC[l] + 2 : PC[l];
+        }
+        break;
+    case Op::LdStVx:
+        for (int l = first; l < last; ++l)
+        {
+            sound[l] = m[l] ? vx[l] : sound[l];
+            PC[l] = m[l] ? PC[l] + 2 : PC[l];
+        }
+        break;
+    case Op::AddIVx:
+        for (int l = first; l < last; ++l)
+        {
+            vf[l] = m[l] ? (regI[l] + vx[l] > 0xFFF ? 1 : 0) : vf[l];
+            regI[l] = m[l] ? regI[l] + vx[l] : regI[l];
+            PC[l] = m[l] ? PC[l] + 2 : PC[l];
+        }
+        break;
+    case Op::LdFVx:
+        for (int l = first; l < last; ++l)
+        {
+            regI[l] = m[l] ? vx[l] * 0x5 : regI[l];
+            PC[l] = m[l] ? PC[l] + 2 : PC[l];
+        }
+        break;
+    case Op::LdBVx:
+        for (int l = first; l < last; ++l)
+        {
+            if (m[l])
+            {
+                writeMemory(l, regI[l], vx[l] / 100);
+                writeMemory(l, regI[l] + 1, (vx[l] / 10) % 10);
+                writeMemory(l, regI[l] + 2, (vx[l] % 100) % 10);
+                PC[l] += 2;
+            }
+        }
+        break;
+    case Op::LdIVx:
+        for (int l = first; l < last; ++l)
+        {
+            if (m[l])
+            {
+                for (int i = 0; i <= in.x; ++i)
+                {
+                    writeMemory(l, regI[l] + i, reg(i)[l]);
+                }
+                if (Q::loadStoreIncrementsI)
+                {
+                    regI[l] += in.x + 1;
+                }
+                PC[l] += 2;
+            }
+        }
+        break;
+    case Op::LdVxI:
+        for (int l = first; l < last; ++l)
+        {
+            if (m[l])
+            {
+                const std::uint8_t* data = laneMemory(l);
+                for (int i = 0; i <= in.x; ++i)
+                {
+                    reg(i)[l] = data[(regI[l] + i) & ADDRESS_MASK];
+                }
+                if (Q::loadStoreIncrementsI)
+                {
+                    regI[l] += in.x + 1;
+                }
+                PC[l] += 2;
+            }
+        }
+        break;
+    default:
+        // Invalid opcodes leave the lane where it is, as Chip8::opInvalid does
+        break;
+    }
+}
+
+// Chip8::drawSprite on packed rows: a sprite row is shifted, or rotated
+// when sprites wrap, into place and XORed in; any overlap is a collision.
+template <class Q>
+void Chip8Batch::drawSprite(const Instruction& in, int lane)
+{
+    const int left = reg(in.x)[lane] & (Display::WIDTH - 1);
+    const int top = reg(in.y)[lane] & (Display::HEIGHT - 1);
+    const int height = Display::spriteHeight<Q::spritesWrap>(top, in.n());
+    const std::uint8_t* data = laneMemory(lane);
+
+    std::uint8_t collision = 0;
+    for (int yline = 0; yline < height; ++yline)
+    {
+        const std::uint64_t bits = Display::spriteRow<Q::spritesWrap>(data[(I[lane] + yline) & ADDRESS_MASK], left);
+        std::uint64_t& pixels = row((top + yline) & (Display::HEIGHT - 1))[lane];
+        collision |= (pixels & bits) != 0;
+        pixels ^= bits;
+    }
+    reg(0xF)[lane] = collision;
+}
+
+void Chip8Batch::updateTimers()
+{
+    // Lanes have no speaker, so the sound timer only counts down
+    std::uint8_t* delay = delayTimer.data();
+    std::uint8_t* sound = soundTimer.data();
+    for (int l = 0; l < lanes; ++l)
+    {
+        delay[l] -= delay[l] > 0;
+        sound[l] -= sound[l] > 0;
+    }
+}
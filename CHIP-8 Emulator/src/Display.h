@@ -1,48 +1,82 @@
 #pragma once
 
 #include <cstdint>
-#include <GL/glew.h>
+#include "StateHash.h"
 
 enum class Pixel
 {
     Black = 0,
     White = 1,
 };
-
-class Display
+
+// Monochrome framebuffer, one 64-bit word per row with pixel x in bit
+// 63 - x, so a sprite row is drawn with one AND and one XOR. Presentation
+// lives in Presenter, which uploads the rows as they are, so the core can
+// run without a graphics context.
+class Display
 {
 public:
     Display();
-    ~Display();
 
-    void init();
-    void update();
-    void render();
     void clear();
     void set(int x, int y, Pixel p);
     Pixel get(int x, int y) const;
+    std::uint64_t getRow(int y) const { return rows[y]; }
+    void setRow(int y, std::uint64_t row);
+    // Toggles the pixels set in mask and returns true if any was lit
+    bool xorRow(int y, std::uint64_t mask)
+    {
+        const std::uint64_t old = rows[y];
+        rows[y] = old ^ mask;
+        hash += displayRowHashTerm(y, rows[y]) - displayRowHashTerm(y, old);
+        dirtyRows |= static_cast<std::uint32_t>(mask != 0) << y;
+        return (old & mask) != 0;
+    }
+    // One byte per pixel, 0 or 1, row by row
+    void copyPixels(std::uint8_t* pixels) const;
+    // One bit per pixel, eight bytes per row, leftmost pixel in the high bit
+    void copyPackedPixels(std::uint8_t* rows) const;
+    // Sum of displayRowHashTerm over the rows, kept up to date by every write
+    std::uint64_t getHash() const;
+    // Rows written since the last clearDirtyRows, bit y for row y. A row
+    // drawn back to its old contents stays marked.
+    std::uint32_t getDirtyRows() const { return dirtyRows; }
+    void clearDirtyRows() { dirtyRows = 0; }
+    void markAllRowsDirty() { dirtyRows = ALL_ROWS; }
 
     static const int WIDTH = 64;
     static const int HEIGHT = 32;
+    static const int PACKED_ROW_SIZE = WIDTH / 8;
+    static const std::uint32_t ALL_ROWS = 0xFFFFFFFFu >> (32 - HEIGHT);
+
+    // Sprite placement shared by the engines. Positions are taken modulo
+    // the screen size first, so start coordinates always land on screen.
+    // Wrap selects the VIP behaviour, where a sprite continues on the
+    // opposite edge; otherwise it is clipped at the right and bottom edges.
+
+    // A sprite byte as a row mask at column left: rotated so pixels past
+    // the right edge wrap, or shifted so they fall off
+    template <bool Wrap>
+    static std::uint64_t spriteRow(std::uint8_t bits, int left)
+    {
+        const std::uint64_t sprite = static_cast<std::uint64_t>(bits) << (WIDTH - 8);
+        return Wrap ? (sprite >> left) | (sprite << ((WIDTH - left) & (WIDTH - 1))) : sprite >> left;
+    }
+
+    // Lines of an n-line sprite at row top that are drawn; line i goes to
+    // row (top + i) & (HEIGHT - 1)
+    template <bool Wrap>
+    static int spriteHeight(int top, int n)
+    {
+        return Wrap || top + n <= HEIGHT ? n : HEIGHT - top;
+    }
+
 private:
-    void createBuffers();
-    void createShaders();
-    void createTexture();
-    void cleanUp();
-
-    static const int SIZE = WIDTH * HEIGHT;
-    static const int NUM_COLORS = 3;
-    static const char* vertexSource;
-    static const char* fragmentSource;
-
-    std::uint8_t bitmap[HEIGHT][WIDTH][NUM_COLORS];
-
-    GLuint vao;
-    GLuint vbo;
-    GLuint ebo;
-    GLuint vertexShader;
-    GLuint fragmentShader;
-    GLuint shaderProgram;
-    GLuint texture;
-};
-
+    std::uint64_t rows[HEIGHT];
+    std::uint64_t hash;
+    std::uint32_t dirtyRows;
+};
+
+static_assert((Display::WIDTH & (Display::WIDTH - 1)) == 0 && (Display::HEIGHT & (Display::HEIGHT - 1)) == 0,
+    "Sprite wrapping masks coordinates with the screen size");
+static_assert(Display::HEIGHT <= 32, "Dirty rows are tracked in a 32-bit mask");
@@ -0,0 +1,77 @@
+#include "Environment.h"
+
+Environment::Environment(int instanceCount, const char* programPath, Observation format, Dispatch dispatch, int workerCount) :
+    format(format),
+    fleet(instanceCount, programPath, dispatch, workerCount)
+{
+    if (instanceCount > 0)
+    {
+        fleet.getInstance(0).snapshot(initial);
+    }
+}
+
+void Environment::reset(const std::uint32_t* seeds, std::uint8_t* observations)
+{
+    for (int i = 0; i < fleet.getInstanceCount(); ++i)
+    {
+        Chip8& chip8 = fleet.getInstance(i);
+        chip8.restore(initial);
+        chip8.seed(seeds[i]);
+    }
+    observe(observations);
+}
+
+void Environment::step(const std::uint16_t* actions, int framesPerStep, std::uint8_t* observations)
+{
+    for (int i = 0; i < fleet.getInstanceCount(); ++i)
+    {
+        fleet.getInstance(i).setKeys(actions[i]);
+    }
+    fleet.runFrames(framesPerStep);
+    observe(observations);
+}
+
+void Environment::setClockRate(int instructionsPerSecond)
+{
+    fleet.setClockRate(instructionsPerSecond);
+    // Resets keep the new rate
+    initial.scheduler.setClockRate(instructionsPerSecond);
+}
+
+int Environment::getInstanceCount() const
+{
+    return fleet.getInstanceCount();
+}
+
+int Environment::getObservationSize() const
+{
+    const int rowSize = format == Observation::Packed ? Display::PACKED_ROW_SIZE : Display::WIDTH;
+    return rowSize * Display::HEIGHT;
+}
+
+Chip8& Environment::getInstance(int instance)
+{
+    return fleet.getInstance(instance);
+}
+
+const Fleet& Environment::getFleet() const
+{
+    return fleet;
+}
+
+void Environment::observe(std::uint8_t* observations) const
+{
+    const int size = getObservationSize();
+    for (int i = 0; i < fleet.getInstanceCount(); ++i)
+    {
+        const Display& display = fleet.getInstance(i).getDisplay();
+        if (format == Observation::Packed)
+        {
+            display.copyPackedPixels(observations + i * size);
+        }
+        else
+        {
+            display.copyPixels(observations + i * size);
+        }
+    }
+}
@@ -0,0 +1,42 @@
+#pragma once
+
+#include <cstdint>
+#include "Fleet.h"
+#include "MachineState.h"
+
+// Batched, gym-style training interface over a fleet of machines running
+// one program. Actions are CHIP-8 keypad states, bit i pressing key i.
+// Observations are written into a caller-owned buffer holding one screen
+// per instance back to back, so stepping allocates nothing.
+class Environment
+{
+public:
+    enum class Observation
+    {
+        Bytes,  // uint8_t[N][32][64], 0 or 1 per pixel
+        Packed, // uint8_t[N][32][8], one bit per pixel, leftmost pixel in the high bit
+    };
+
+    Environment(int instanceCount, const char* programPath, Observation format = Observation::Bytes,
+        Dispatch dispatch = Dispatch::Switch, int workerCount = 0);
+
+    // Restarts every instance, seeding instance i with seeds[i]
+    void reset(const std::uint32_t* seeds, std::uint8_t* observations);
+    // Holds actions[i] on instance i for framesPerStep frames
+    void step(const std::uint16_t* actions, int framesPerStep, std::uint8_t* observations);
+    void setClockRate(int instructionsPerSecond);
+
+    int getInstanceCount() const;
+    int getObservationSize() const;
+    Chip8& getInstance(int instance);
+    const Fleet& getFleet() const;
+
+private:
+    void observe(std::uint8_t* observations) const;
+
+    Observation format;
+    Fleet fleet;
+    // The machine as loaded, restored on reset instead of reading the
+    // program again
+    Snapshot initial;
+};
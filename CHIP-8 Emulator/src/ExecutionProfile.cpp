@@ -0,0 +1,80 @@
+#include <fstream>
+#include <iostream>
+#include "ExecutionProfile.h"
+
+ExecutionProfile::ExecutionProfile()
+    : pairs(OP_COUNT * OP_COUNT), triples(OP_COUNT * OP_COUNT * OP_COUNT)
+{
+}
+
+void ExecutionProfile::record(std::uint16_t address, Op op)
+{
+    // Jumps to self and key waits re-execute one address while idle, which
+    // says nothing about hot code and would swamp every other count
+    if (instructions > 0 && address == nextAddress - 2)
+    {
+        return;
+    }
+
+    // Only sequences that fall through from one instruction to the next can
+    // be fused, so any jump or skip starts a new run
+    if (address != nextAddress)
+    {
+        run = 0;
+    }
+
+    int index = static_cast<int>(op);
+    if (run >= 1)
+    {
+        ++pairs[static_cast<int>(recent[1]) * OP_COUNT + index];
+    }
+    if (run >= 2)
+    {
+        ++triples[(static_cast<int>(recent[0]) * OP_COUNT + static_cast<int>(recent[1])) * OP_COUNT + index];
+    }
+
+    recent[0] = recent[1];
+    recent[1] = op;
+    run = run < 2 ? run + 1 : 2;
+    nextAddress = address + 2;
+    ++instructions;
+}
+
+bool ExecutionProfile::save(const char* path) const
+{
+    std::ofstream out(path);
+    if (!out)
+    {
+        std::cerr << "Unable to write profile: " << path << ".\n";
+        return false;
+    }
+
+    out << "instructions " << instructions << '\n';
+    for (int a = 0; a < OP_COUNT; ++a)
+    {
+        for (int b = 0; b < OP_COUNT; ++b)
+        {
+            std::uint64_t count = pairs[a * OP_COUNT + b];
+            if (count > 0)
+            {
+                out << "pair " << opName(static_cast<Op>(a)) << ' ' << opName(static_cast<Op>(b)) << ' ' << count << '\n';
+            }
+        }
+    }
+    for (int a = 0; a < OP_COUNT; ++a)
+    {
+        for (int b = 0; b < OP_COUNT; ++b)
+        {
+            for (int c = 0; c < OP_COUNT; ++c)
+            {
+                std::uint64_t count = triples[(a * OP_COUNT + b) * OP_COUNT + c];
+                if (count > 0)
+                {
+                    out << "triple " << opName(static_cast<Op>(a)) << ' ' << opName(static_cast<Op>(b)) << ' '
+                        << opName(static_cast<Op>(c)) << ' ' << count << '\n';
+                }
+            }
+        }
+    }
+    return true;
+}
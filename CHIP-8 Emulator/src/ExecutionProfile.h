@@ -0,0 +1,27 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+#include "Instruction.h"
+
+// Counts how often each pair and triple of opcodes executes back to back.
+// Saved profiles are the input of tools/SuperinstructionGen, which picks the
+// sequences worth fusing into a single dispatch.
+class ExecutionProfile
+{
+public:
+    ExecutionProfile();
+
+    void record(std::uint16_t address, Op op);
+    bool save(const char* path) const;
+
+private:
+    static const int OP_COUNT = static_cast<int>(Op::Count);
+
+    std::vector<std::uint64_t> pairs;
+    std::vector<std::uint64_t> triples;
+    std::uint64_t instructions = 0;
+    Op recent[2] = { Op::Undecoded, Op::Undecoded };
+    int run = 0;
+    std::uint16_t nextAddress = 0;
+};
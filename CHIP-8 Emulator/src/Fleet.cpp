@@ -0,0 +1,255 @@
+#include "Fleet.h"
+#include <chrono>
+#include <climits>
+
+const std::uint64_t Fleet::UNLIMITED;
+
+Fleet::Fleet(int instanceCount, const char* programPath, Dispatch dispatch, int workerCount) :
+    remaining(0),
+    runInstructions(0),
+    runFrameCount(0)
+{
+    for (int i = 0; i < instanceCount; ++i)
+    {
+        instances.emplace_back(new Chip8(programPath, dispatch));
+    }
+    budgets.assign(instanceCount, UNLIMITED);
+
+    if (workerCount <= 0)
+    {
+        workerCount = static_cast<int>(std::thread::hardware_concurrency());
+        workerCount = workerCount > 0 ? workerCount : 1;
+    }
+    for (int i = 0; i < workerCount; ++i)
+    {
+        workers.emplace_back(new Worker());
+    }
+    // The thread calling runFrames is worker 0
+    for (int i = 1; i < workerCount; ++i)
+    {
+        threads.emplace_back(&Fleet::workerLoop, this, i);
+    }
+}
+
+Fleet::~Fleet()
+{
+    {
+        std::lock_guard<std::mutex> lock(runLock);
+        stopping = true;
+    }
+    runStarted.notify_all();
+    for (std::thread& thread : threads)
+    {
+        thread.join();
+    }
+}
+
+void Fleet::runFrames(int frames)
+{
+    const int count = getInstanceCount();
+    const int workerCount = getWorkerCount();
+    if (frames <= 0 || count == 0)
+    {
+        return;
+    }
+
+    // Deal out one contiguous range per worker; stealing evens out the rest
+    framesPerRun = frames;
+    runInstructions = 0;
+    runFrameCount = 0;
+    for (int i = 0; i < workerCount; ++i)
+    {
+        const Range range = { count * i / workerCount, count * (i + 1) / workerCount };
+        std::lock_guard<std::mutex> lock(workers[i]->lock);
+        workers[i]->ranges.clear();
+        if (range.begin < range.end)
+        {
+            workers[i]->ranges.push_back(range);
+        }
+    }
+    remaining = count;
+
+    const auto start = std::chrono::steady_clock::now();
+    {
+        std::lock_guard<std::mutex> lock(runLock);
+        ++generation;
+        busyWorkers = workerCount - 1;
+    }
+    runStarted.notify_all();
+
+    work(0);
+    {
+        std::unique_lock<std::mutex> lock(runLock);
+        runFinished.wait(lock, [this] { return busyWorkers == 0; });
+    }
+
+    lastSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    lastInstructions = runInstructions;
+    lastFrames = runFrameCount;
+    totalInstructions += lastInstructions;
+    totalFrames += lastFrames;
+}
+
+void Fleet::setClockRate(int instructionsPerSecond)
+{
+    for (std::unique_ptr<Chip8>& chip8 : instances)
+    {
+        chip8->setClockRate(instructionsPerSecond);
+    }
+}
+
+void Fleet::setBudget(int instance, std::uint64_t instructions)
+{
+    budgets[instance] = instructions;
+}
+
+int Fleet::getInstanceCount() const
+{
+    return static_cast<int>(instances.size());
+}
+
+int Fleet::getWorkerCount() const
+{
+    return static_cast<int>(workers.size());
+}
+
+Chip8& Fleet::getInstance(int instance)
+{
+    return *instances[instance];
+}
+
+const Chip8& Fleet::getInstance(int instance) const
+{
+    return *instances[instance];
+}
+
+double Fleet::getInstructionsPerSecond() const
+{
+    return lastSeconds > 0.0 ? lastInstructions / lastSeconds : 0.0;
+}
+
+double Fleet::getFramesPerSecond() const
+{
+    return lastSeconds > 0.0 ? lastFrames / lastSeconds : 0.0;
+}
+
+std::uint64_t Fleet::getTotalInstructions() const
+{
+    return totalInstructions;
+}
+
+std::uint64_t Fleet::getTotalFrames() const
+{
+    return totalFrames;
+}
+
+void Fleet::workerLoop(int index)
+{
+    std::uint64_t seen = 0;
+    for (;;)
+    {
+        {
+            std::unique_lock<std::mutex> lock(runLock);
+            runStarted.wait(lock, [this, seen] { return stopping || generation != seen; });
+            if (stopping)
+            {
+                return;
+            }
+            seen = generation;
+        }
+
+        work(index);
+
+        {
+            std::lock_guard<std::mutex> lock(runLock);
+            --busyWorkers;
+        }
+        runFinished.notify_one();
+    }
+}
+
+void Fleet::work(int index)
+{
+    Range range;
+    while (remaining > 0)
+    {
+        if (!popRange(index, range) && !stealRange(index, range))
+        {
+            // Everything left is being run by other workers
+            std::this_thread::yield();
+            continue;
+        }
+
+        // Split off upper halves for thieves until the range is small
+        while (range.end - range.begin > GRAIN)
+        {
+            const int middle = range.begin + (range.end - range.begin) / 2;
+            {
+                std::lock_guard<std::mutex> lock(workers[index]->lock);
+                workers[index]->ranges.push_back({ middle, range.end });
+            }
+            range.end = middle;
+        }
+
+        std::uint64_t instructions = 0;
+        std::uint64_t frames = 0;
+        for (int i = range.begin; i < range.end; ++i)
+        {
+            runInstance(i, instructions, frames);
+        }
+        runInstructions += instructions;
+        runFrameCount += frames;
+        remaining -= range.end - range.begin;
+    }
+}
+
+bool Fleet::popRange(int index, Range& range)
+{
+    // The owner takes the most recently split, smallest range
+    Worker& worker = *workers[index];
+    std::lock_guard<std::mutex> lock(worker.lock);
+    if (worker.ranges.empty())
+    {
+        return false;
+    }
+    range = worker.ranges.back();
+    worker.ranges.pop_back();
+    return true;
+}
+
+bool Fleet::stealRange(int index, Range& range)
+{
+    // Thieves take the oldest, largest range of the next busy worker
+    const int workerCount = getWorkerCount();
+    for (int i = 1; i < workerCount; ++i)
+    {
+        Worker& victim = *workers[(index + i) % workerCount];
+        std::lock_guard<std::mutex> lock(victim.lock);
+        if (!victim.ranges.empty())
+        {
+            range = victim.ranges.front();
+            victim.ranges.pop_front();
+            return true;
+        }
+    }
+    return false;
+}
+
+void Fleet::runInstance(int instance, std::uint64_t& instructions, std::uint64_t& frames)
+{
+    Chip8& chip8 = *instances[instance];
+    const std::uint64_t budget = budgets[instance];
+    const std::uint64_t start = chip8.getCycles();
+    for (int frame = 0; frame < framesPerRun; ++frame)
+    {
+        const std::uint64_t used = chip8.getCycles();
+        if (used >= budget)
+        {
+            break;
+        }
+        const std::uint64_t left = budget - used;
+        chip8.runFrame(left < INT_MAX ? static_cast<int>(left) : INT_MAX);
+        ++frames;
+    }
+    instructions += chip8.getCycles() - start;
+}
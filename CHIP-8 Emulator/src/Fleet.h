@@ -0,0 +1,88 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "Chip8.h"
+
+// Owns a pool of headless machines and steps them on every core. Each
+// worker keeps a deque of instance ranges: it splits its own ranges from
+// the bottom and idle workers steal the largest ones from the top.
+class Fleet
+{
+public:
+    static const std::uint64_t UNLIMITED = UINT64_MAX;
+
+    Fleet(int instanceCount, const char* programPath, Dispatch dispatch = Dispatch::Switch, int workerCount = 0);
+    ~Fleet();
+
+    // Runs every instance for the given number of frames, or until its
+    // budget is spent. Returns when all instances are done.
+    void runFrames(int frames);
+    void setClockRate(int instructionsPerSecond);
+    // Instructions an instance may execute since its last reset
+    void setBudget(int instance, std::uint64_t instructions);
+
+    int getInstanceCount() const;
+    int getWorkerCount() const;
+    Chip8& getInstance(int instance);
+    const Chip8& getInstance(int instance) const;
+
+    // Aggregate throughput of the last runFrames call
+    double getInstructionsPerSecond() const;
+    double getFramesPerSecond() const;
+    std::uint64_t getTotalInstructions() const;
+    std::uint64_t getTotalFrames() const;
+
+private:
+    struct Range
+    {
+        int begin;
+        int end;
+    };
+
+    struct Worker
+    {
+        std::mutex lock;
+        std::deque<Range> ranges;
+    };
+
+    void workerLoop(int index);
+    void work(int index);
+    bool popRange(int index, Range& range);
+    bool stealRange(int index, Range& range);
+    void runInstance(int instance, std::uint64_t& instructions, std::uint64_t& frames);
+
+    // Ranges at most this long are run rather than split further
+    static const int GRAIN = 4;
+
+    std::vector<std::unique_ptr<Chip8>> instances;
+    std::vector<std::uint64_t> budgets;
+    std::vector<std::unique_ptr<Worker>> workers;
+    std::vector<std::thread> threads;
+
+    // Work of the current run
+    int framesPerRun = 0;
+    std::atomic<int> remaining;
+    std::atomic<std::uint64_t> runInstructions;
+    std::atomic<std::uint64_t> runFrameCount;
+
+    // Wakes the background workers for each run
+    std::mutex runLock;
+    std::condition_variable runStarted;
+    std::condition_variable runFinished;
+    std::uint64_t generation = 0;
+    int busyWorkers = 0;
+    bool stopping = false;
+
+    double lastSeconds = 0.0;
+    std::uint64_t lastInstructions = 0;
+    std::uint64_t lastFrames = 0;
+    std::uint64_t totalInstructions = 0;
+    std::uint64_t totalFrames = 0;
+};
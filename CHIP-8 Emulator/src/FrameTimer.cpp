@@ -0,0 +1,42 @@
+#include "FrameTimer.h"
+#include <cmath>
+
+void FrameTimer::begin()
+{
+    start = std::chrono::steady_clock::now();
+}
+
+void FrameTimer::end()
+{
+    const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    ++frames;
+    totalSeconds += seconds;
+    totalSquaredSeconds += seconds * seconds;
+    maxSeconds = seconds > maxSeconds ? seconds : maxSeconds;
+}
+
+std::uint64_t FrameTimer::getFrameCount() const
+{
+    return frames;
+}
+
+double FrameTimer::getAverageMilliseconds() const
+{
+    return frames ? totalSeconds / frames * 1000.0 : 0.0;
+}
+
+double FrameTimer::getDeviationMilliseconds() const
+{
+    if (frames == 0)
+    {
+        return 0.0;
+    }
+    const double mean = totalSeconds / frames;
+    const double variance = totalSquaredSeconds / frames - mean * mean;
+    return variance > 0.0 ? std::sqrt(variance) * 1000.0 : 0.0;
+}
+
+double FrameTimer::getMaxMilliseconds() const
+{
+    return maxSeconds * 1000.0;
+}
@@ -0,0 +1,27 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+
+// Measures the host time spent on each frame: emulation, upload and the
+// submission of draw calls, but not the wait for vertical sync, which
+// would hide stalls behind the swap interval.
+class FrameTimer
+{
+public:
+    void begin();
+    void end();
+
+    std::uint64_t getFrameCount() const;
+    double getAverageMilliseconds() const;
+    // Standard deviation of the frame time; lower means steadier frames
+    double getDeviationMilliseconds() const;
+    double getMaxMilliseconds() const;
+
+private:
+    std::chrono::steady_clock::time_point start;
+    std::uint64_t frames = 0;
+    double totalSeconds = 0.0;
+    double totalSquaredSeconds = 0.0;
+    double maxSeconds = 0.0;
+};
@@ -0,0 +1,112 @@
+#include "Instruction.h"
+
+static Op decodeOp(std::uint16_t opcode)
+{
+    switch (opcode & 0xF000)
+    {
+    case 0x0000:
+        switch (opcode)
+        {
+        case 0x00E0: return Op::Cls;
+        case 0x00EE: return Op::Ret;
+        default: return Op::Invalid;
+        }
+    case 0x1000: return Op::Jp;
+    case 0x2000: return Op::Call;
+    case 0x3000: return Op::SeVxByte;
+    case 0x4000: return Op::SneVxByte;
+    case 0x5000: return Op::SeVxVy;
+    case 0x6000: return Op::LdVxByte;
+    case 0x7000: return Op::AddVxByte;
+    case 0x8000:
+        switch (opcode & 0x000F)
+        {
+        case 0x0000: return Op::LdVxVy;
+        case 0x0001: return Op::OrVxVy;
+        case 0x0002: return Op::AndVxVy;
+        case 0x0003: return Op::XorVxVy;
+        case 0x0004: return Op::AddVxVy;
+        case 0x0005: return Op::SubVxVy;
+        case 0x0006: return Op::ShrVx;
+        case 0x0007: return Op::SubnVxVy;
+        case 0x000E: return Op::ShlVx;
+        default: return Op::Invalid;
+        }
+    case 0x9000: return Op::SneVxVy;
+    case 0xA000: return Op::LdI;
+    case 0xB000: return Op::JpV0;
+    case 0xC000: return Op::Rnd;
+    case 0xD000: return Op::Drw;
+    case 0xE000:
+        switch (opcode & 0x00FF)
+        {
+        case 0x009E: return Op::Skp;
+        case 0x00A1: return Op::Sknp;
+        default: return Op::Invalid;
+        }
+    case 0xF000:
+        switch (opcode & 0x00FF)
+        {
+        case 0x0007: return Op::LdVxDt;
+        case 0x000A: return Op::LdVxK;
+        case 0x0015: return Op::LdDtVx;
+        case 0x0018: return Op::LdStVx;
+        case 0x001E: return Op::AddIVx;
+        case 0x0029: return Op::LdFVx;
+        case 0x0033: return Op::LdBVx;
+        case 0x0055: return Op::LdIVx;
+        case 0x0065: return Op::LdVxI;
+        default: return Op::Invalid;
+        }
+    default:
+        return Op::Invalid;
+    }
+}
+
+Instruction decode(std::uint16_t opcode)
+{
+    Instruction instruction;
+    instruction.op = decodeOp(opcode);
+    instruction.x = opcode >> 8 & 0x000F;
+    instruction.y = opcode >> 4 & 0x000F;
+    instruction.kk = opcode & 0x00FF;
+    return instruction;
+}
+
+const char* opName(Op op)
+{
+    static const char* const NAMES[static_cast<int>(Op::Count)] =
+    {
+        "Undecoded", "Invalid", "Cls", "Ret", "Jp", "Call",
+        "SeVxByte", "SneVxByte", "SeVxVy", "LdVxByte", "AddVxByte",
+        "LdVxVy", "OrVxVy", "AndVxVy", "XorVxVy", "AddVxVy", "SubVxVy",
+        "ShrVx", "SubnVxVy", "ShlVx", "SneVxVy", "LdI", "JpV0", "Rnd",
+        "Drw", "Skp", "Sknp", "LdVxDt", "LdVxK", "LdDtVx", "LdStVx",
+        "AddIVx", "LdFVx", "LdBVx", "LdIVx", "LdVxI"
+    };
+    int index = static_cast<int>(op);
+    return index < static_cast<int>(Op::Count) ? NAMES[index] : "Fused";
+}
+
+bool endsBlock(Op op)
+{
+    switch (op)
+    {
+    case Op::Undecoded:
+    case Op::Invalid:
+    case Op::Ret:
+    case Op::Jp:
+    case Op::Call:
+    case Op::SeVxByte:
+    case Op::SneVxByte:
+    case Op::SeVxVy:
+    case Op::SneVxVy:
+    case Op::JpV0:
+    case Op::Skp:
+    case Op::Sknp:
+    case Op::LdVxK:
+        return true;
+    default:
+        return false;
+    }
+}
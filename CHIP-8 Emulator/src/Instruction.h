@@ -0,0 +1,66 @@
+#pragma once
+
+#include <cstdint>
+
+enum class Op : std::uint8_t
+{
+    Undecoded = 0,
+    Invalid,
+    Cls,        // 00E0
+    Ret,        // 00EE
+    Jp,         // 1NNN
+    Call,       // 2NNN
+    SeVxByte,   // 3XKK
+    SneVxByte,  // 4XKK
+    SeVxVy,     // 5XY0
+    LdVxByte,   // 6XKK
+    AddVxByte,  // 7XKK
+    LdVxVy,     // 8XY0
+    OrVxVy,     // 8XY1
+    AndVxVy,    // 8XY2
+    XorVxVy,    // 8XY3
+    AddVxVy,    // 8XY4
+    SubVxVy,    // 8XY5
+    ShrVx,      // 8XY6
+    SubnVxVy,   // 8XY7
+    ShlVx,      // 8XYE
+    SneVxVy,    // 9XY0
+    LdI,        // ANNN
+    JpV0,       // BNNN
+    Rnd,        // CXKK
+    Drw,        // DXYN
+    Skp,        // EX9E
+    Sknp,       // EXA1
+    LdVxDt,     // FX07
+    LdVxK,      // FX0A
+    LdDtVx,     // FX15
+    LdStVx,     // FX18
+    AddIVx,     // FX1E
+    LdFVx,      // FX29
+    LdBVx,      // FX33
+    LdIVx,      // FX55
+    LdVxI,      // FX65
+    Count
+};
+
+// A decoded opcode. The operands are extracted once so that executing the
+// instruction again does not need to fetch or mask the raw opcode.
+struct Instruction
+{
+    Op op = Op::Undecoded;
+    std::uint8_t x = 0;
+    std::uint8_t y = 0;
+    std::uint8_t kk = 0;
+
+    std::uint8_t n() const { return kk & 0x0F; }
+    std::uint16_t nnn() const { return static_cast<std::uint16_t>(x << 8 | kk); }
+};
+
+Instruction decode(std::uint16_t opcode);
+
+// Mnemonic used by execution profiles and generated tables, e.g. "LdVxByte"
+const char* opName(Op op);
+
+// True for instructions that may transfer control anywhere other than the
+// next instruction, which is where translated blocks must stop.
+bool endsBlock(Op op);
@@ -0,0 +1,425 @@
+#include "Jit.h"
+
+#if CHIP8_JIT
+
+#include <iostream>
+#include <sys/mman.h>
+#include "Chip8.h"
+
+// x86-64 register numbers used in ModRM encodings
+static const std::uint8_t RAX = 0;
+static const std::uint8_t RCX = 1;
+static const std::uint8_t RDX = 2;
+static const std::uint8_t RBX = 3;
+
+Jit::Jit(Chip8& chip8)
+{
+    // Field offsets are the same for every Chip8, so they are taken once
+    // and baked into the generated code as displacements from rbx.
+    const std::uint8_t* base = reinterpret_cast<const std::uint8_t*>(&chip8);
+    vOffset = static_cast<std::int32_t>(reinterpret_cast<const std::uint8_t*>(chip8.state.V) - base);
+    iOffset = static_cast<std::int32_t>(reinterpret_cast<const std::uint8_t*>(&chip8.state.I) - base);
+    pcOffset = static_cast<std::int32_t>(reinterpret_cast<const std::uint8_t*>(&chip8.state.pc) - base);
+    delayTimerOffset = static_cast<std::int32_t>(reinterpret_cast<const std::uint8_t*>(&chip8.state.delayTimer) - base);
+    soundTimerOffset = static_cast<std::int32_t>(reinterpret_cast<const std::uint8_t*>(&chip8.state.soundTimer) - base);
+
+    // Code is never writable and executable at once: the buffer is mapped
+    // writable and flipped to executable once each block is emitted
+    void* memory = mmap(NULL, CODE_SIZE, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (memory == MAP_FAILED)
+    {
+        std::cerr << "Unable to allocate JIT code buffer, interpreting instead.\n";
+        return;
+    }
+    code = static_cast<std::uint8_t*>(memory);
+}
+
+Jit::~Jit()
+{
+    if (code != nullptr)
+    {
+        munmap(code, CODE_SIZE);
+    }
+}
+
+bool Jit::isAvailable() const
+{
+    return code != nullptr;
+}
+
+void Jit::run(Chip8& chip8, int cycles)
+{
+    while (cycles > 0)
+    {
+        const Entry& entry = lookup(chip8, chip8.state.pc);
+
+        // Blocks run to completion, so a budget smaller than the block is
+        // finished off one instruction at a time.
+        if (entry.code == nullptr || entry.length > cycles)
+        {
+            chip8.executeOpcode();
+            --cycles;
+            continue;
+        }
+        cycles -= entry.code(&chip8);
+    }
+}
+
+void Jit::invalidate(std::uint16_t address)
+{
+    if (address >= MEMORY_SIZE || coverage[address] == 0)
+    {
+        return;
+    }
+
+    int first = address - 2 * MAX_BLOCK_LENGTH + 1;
+    for (int start = first < 0 ? 0 : first; start <= address; ++start)
+    {
+        if (entries[start].code != nullptr && address < start + 2 * entries[start].length)
+        {
+            erase(start);
+        }
+    }
+    ++generation;
+}
+
+void Jit::clear()
+{
+    for (int start = 0; start < MEMORY_SIZE; ++start)
+    {
+        entries[start] = Entry();
+        coverage[start] = 0;
+    }
+    codeUsed = 0;
+    ++generation;
+}
+
+void Jit::erase(int start)
+{
+    for (int i = start; i < start + 2 * entries[start].length; ++i)
+    {
+        --coverage[i];
+    }
+    entries[start] = Entry();
+}
+
+const Jit::Entry& Jit::lookup(Chip8& chip8, std::uint16_t address)
+{
+    // Compiled code stores absolute pc values, so a pc past the end of
+    // memory is left to the interpreter, which wraps its fetches
+    static const Entry NONE;
+    if (address >= MEMORY_SIZE)
+    {
+        return NONE;
+    }
+
+    Entry& entry = entries[address];
+    if (entry.code == nullptr && code != nullptr && address + 1 < MEMORY_SIZE)
+    {
+        compile(chip8, address, entry);
+    }
+    return entry;
+}
+
+void Jit::compile(Chip8& chip8, std::uint16_t address, Entry& entry)
+{
+    // Stale code is only reclaimed by starting over
+    if (CODE_SIZE - codeUsed < MAX_BLOCK_BYTES)
+    {
+        clear();
+    }
+    // Only the pages the block can reach are made writable, so code that
+    // rewrites itself pays for one or two pages per recompile
+    const std::size_t offset = codeUsed;
+    if (!protect(offset, MAX_BLOCK_BYTES, PROT_READ | PROT_WRITE))
+    {
+        return;
+    }
+
+    std::uint8_t* start = code + offset;
+
+    // push rbx; mov rbx, rdi
+    emit8(0x53);
+    emit8(0x48); emit8(0x89); emit8(0xFB);
+
+    std::uint16_t pc = address;
+    int length = 0;
+    bool terminal = false;
+    while (pc + 1 < MEMORY_SIZE && length < MAX_BLOCK_LENGTH && !terminal)
+    {
+        Instruction in = decode(chip8.memory.readOpcode(pc));
+        terminal = endsBlock(in.op);
+        ++length;
+        if (!compileInline(in, pc, chip8.quirks))
+        {
+            emitHelperCall(in, pc, length, terminal);
+        }
+        pc += 2;
+    }
+
+    if (!terminal)
+    {
+        // mov word [rbx + pc], imm16
+        emit8(0x66); emit8(0xC7); emitModRM(0, pcOffset); emit16(pc);
+    }
+    emitReturn(length);
+    if (!protect(offset, MAX_BLOCK_BYTES, PROT_READ | PROT_EXEC))
+    {
+        return;
+    }
+
+    entry.code = reinterpret_cast<CompiledBlock>(start);
+    entry.length = length;
+    for (int i = address; i < pc; ++i)
+    {
+        ++coverage[i];
+    }
+}
+
+bool Jit::protect(std::size_t offset, std::size_t size, int protection)
+{
+    const std::size_t first = offset / PAGE_SIZE * PAGE_SIZE;
+    const std::size_t end = (offset + size + PAGE_SIZE - 1) / PAGE_SIZE * PAGE_SIZE;
+    if (mprotect(code + first, end - first, protection) == 0)
+    {
+        return true;
+    }
+
+    // Without a usable buffer every block is interpreted from now on
+    std::cerr << "Unable to change JIT code protection, interpreting instead.\n";
+    clear();
+    munmap(code, CODE_SIZE);
+    code = nullptr;
+    return false;
+}
+
+bool Jit::compileInline(const Instruction& in, std::uint16_t address, const Quirks& quirks)
+{
+    // Flag-setting arithmetic is ordered differently when VF is also an
+    // operand; leave those to the interpreter.
+    const bool usesVF = in.x == 0xF || in.y == 0xF;
+
+    switch (in.op)
+    {
+    case Op::Jp:
+        // mov word [rbx + pc], nnn
+        emit8(0x66); emit8(0xC7); emitModRM(0, pcOffset); emit16(in.nnn());
+        return true;
+    case Op::SeVxByte:
+    case Op::SneVxByte:
+        // cmp byte [rbx + Vx], kk
+        emit8(0x80); emitModRM(7, registerOffset(in.x)); emit8(in.kk);
+        emitSkip(in.op == Op::SeVxByte, address);
+        return true;
+    case Op::SeVxVy:
+    case Op::SneVxVy:
+        // movzx eax, byte [rbx + Vx]; cmp al, byte [rbx + Vy]
+        emit8(0x0F); emit8(0xB6); emitModRM(RAX, registerOffset(in.x));
+        emit8(0x3A); emitModRM(RAX, registerOffset(in.y));
+        emitSkip(in.op == Op::SeVxVy, address);
+        return true;
+    case Op::LdVxByte:
+        // mov byte [rbx + Vx], kk
+        emit8(0xC6); emitModRM(0, registerOffset(in.x)); emit8(in.kk);
+        return true;
+    case Op::AddVxByte:
+        // add byte [rbx + Vx], kk
+        emit8(0x80); emitModRM(0, registerOffset(in.x)); emit8(in.kk);
+        return true;
+    case Op::LdVxVy:
+        // movzx eax, byte [rbx + Vy]; mov byte [rbx + Vx], al
+        emit8(0x0F); emit8(0xB6); emitModRM(RAX, registerOffset(in.y));
+        emit8(0x88); emitModRM(RAX, registerOffset(in.x));
+        return true;
+    case Op::OrVxVy:
+    case Op::AndVxVy:
+    case Op::XorVxVy:
+        // movzx ecx, byte [rbx + Vy]; or/and/xor byte [rbx + Vx], cl
+        emit8(0x0F); emit8(0xB6); emitModRM(RCX, registerOffset(in.y));
+        emit8(in.op == Op::OrVxVy ? 0x08 : in.op == Op::AndVxVy ? 0x20 : 0x30);
+        emitModRM(RCX, registerOffset(in.x));
+        if (quirks.logicResetsVF)
+        {
+            // mov byte [rbx + VF], 0
+            emit8(0xC6); emitModRM(0, registerOffset(0xF)); emit8(0x00);
+        }
+        return true;
+    case Op::AddVxVy:
+    case Op::SubVxVy:
+        if (usesVF)
+        {
+            return false;
+        }
+        // movzx ecx, byte [rbx + Vy]; add/sub byte [rbx + Vx], cl
+        emit8(0x0F); emit8(0xB6); emitModRM(RCX, registerOffset(in.y));
+        emit8(in.op == Op::AddVxVy ? 0x00 : 0x28); emitModRM(RCX, registerOffset(in.x));
+        // setc dl (carry) or setnc dl (no borrow); mov byte [rbx + VF], dl
+        emit8(0x0F); emit8(in.op == Op::AddVxVy ? 0x92 : 0x93); emit8(0xC2);
+        emit8(0x88); emitModRM(RDX, registerOffset(0xF));
+        return true;
+    case Op::SubnVxVy:
+        if (usesVF)
+        {
+            return false;
+        }
+        // movzx eax, byte [rbx + Vy]; sub al, byte [rbx + Vx]; setnc dl
+        emit8(0x0F); emit8(0xB6); emitModRM(RAX, registerOffset(in.y));
+        emit8(0x2A); emitModRM(RAX, registerOffset(in.x));
+        emit8(0x0F); emit8(0x93); emit8(0xC2);
+        // mov byte [rbx + Vx], al; mov byte [rbx + VF], dl
+        emit8(0x88); emitModRM(RAX, registerOffset(in.x));
+        emit8(0x88); emitModRM(RDX, registerOffset(0xF));
+        return true;
+    case Op::ShrVx:
+    case Op::ShlVx:
+        if (in.x == 0xF || (quirks.shiftReadsVy && in.y == 0xF))
+        {
+            return false;
+        }
+        if (quirks.shiftReadsVy)
+        {
+            // movzx eax, byte [rbx + Vy]; shr/shl al, 1; setc dl; mov byte [rbx + Vx], al
+            emit8(0x0F); emit8(0xB6); emitModRM(RAX, registerOffset(in.y));
+            emit8(0xD0); emit8(in.op == Op::ShrVx ? 0xE8 : 0xE0);
+            emit8(0x0F); emit8(0x92); emit8(0xC2);
+            emit8(0x88); emitModRM(RAX, registerOffset(in.x));
+        }
+        else
+        {
+            // shr/shl byte [rbx + Vx], 1; setc dl
+            emit8(0xD0); emitModRM(in.op == Op::ShrVx ? 5 : 4, registerOffset(in.x));
+            emit8(0x0F); emit8(0x92); emit8(0xC2);
+        }
+        // mov byte [rbx + VF], dl
+        emit8(0x88); emitModRM(RDX, registerOffset(0xF));
+        return true;
+    case Op::LdI:
+        // mov word [rbx + I], nnn
+        emit8(0x66); emit8(0xC7); emitModRM(0, iOffset); emit16(in.nnn());
+        return true;
+    case Op::AddIVx:
+        if (in.x == 0xF)
+        {
+            return false;
+        }
+        // movzx eax, word [rbx + I]; movzx ecx, byte [rbx + Vx]; add eax, ecx
+        emit8(0x0F); emit8(0xB7); emitModRM(RAX, iOffset);
+        emit8(0x0F); emit8(0xB6); emitModRM(RCX, registerOffset(in.x));
+        emit8(0x01); emit8(0xC8);
+        // cmp eax, 0xFFF; seta dl; mov byte [rbx + VF], dl; mov word [rbx + I], ax
+        emit8(0x3D); emit32(0xFFF);
+        emit8(0x0F); emit8(0x97); emit8(0xC2);
+        emit8(0x88); emitModRM(RDX, registerOffset(0xF));
+        emit8(0x66); emit8(0x89); emitModRM(RAX, iOffset);
+        return true;
+    case Op::LdFVx:
+        // movzx eax, byte [rbx + Vx]; lea eax, [rax + rax * 4]; mov word [rbx + I], ax
+        emit8(0x0F); emit8(0xB6); emitModRM(RAX, registerOffset(in.x));
+        emit8(0x8D); emit8(0x04); emit8(0x80);
+        emit8(0x66); emit8(0x89); emitModRM(RAX, iOffset);
+        return true;
+    case Op::LdVxDt:
+        // movzx eax, byte [rbx + delayTimer]; mov byte [rbx + Vx], al
+        emit8(0x0F); emit8(0xB6); emitModRM(RAX, delayTimerOffset);
+        emit8(0x88); emitModRM(RAX, registerOffset(in.x));
+        return true;
+    case Op::LdDtVx:
+    case Op::LdStVx:
+        // movzx eax, byte [rbx + Vx]; mov byte [rbx + timer], al
+        emit8(0x0F); emit8(0xB6); emitModRM(RAX, registerOffset(in.x));
+        emit8(0x88); emitModRM(RAX, in.op == Op::LdDtVx ? delayTimerOffset : soundTimerOffset);
+        return true;
+    default:
+        return false;
+    }
+}
+
+void Jit::emitHelperCall(const Instruction& in, std::uint16_t address, int executed, bool terminal)
+{
+    std::uint32_t packed = static_cast<std::uint32_t>(in.op) | in.x << 8 | in.y << 16 | in.kk << 24;
+
+    // mov word [rbx + pc], address; mov rdi, rbx; mov esi, packed
+    emit8(0x66); emit8(0xC7); emitModRM(0, pcOffset); emit16(address);
+    emit8(0x48); emit8(0x89); emit8(0xDF);
+    emit8(0xBE); emit32(packed);
+    // mov rax, interpret; call rax
+    emit8(0x48); emit8(0xB8); emit64(reinterpret_cast<std::uint64_t>(&Jit::interpret));
+    emit8(0xFF); emit8(0xD0);
+
+    if (!terminal)
+    {
+        // Leave early if the handler overwrote compiled code:
+        // test al, al; jz +7; mov eax, executed; pop rbx; ret
+        emit8(0x84); emit8(0xC0);
+        emit8(0x74); emit8(0x07);
+        emitReturn(executed);
+    }
+}
+
+void Jit::emitSkip(bool equal, std::uint16_t address)
+{
+    // mov ecx, address + 2; mov edx, address + 4; cmove/cmovne ecx, edx
+    emit8(0xB9); emit32(address + 2);
+    emit8(0xBA); emit32(address + 4);
+    emit8(0x0F); emit8(equal ? 0x44 : 0x45); emit8(0xCA);
+    // mov word [rbx + pc], cx
+    emit8(0x66); emit8(0x89); emitModRM(RCX, pcOffset);
+}
+
+void Jit::emitReturn(int executed)
+{
+    // mov eax, executed; pop rbx; ret
+    emit8(0xB8); emit32(static_cast<std::uint32_t>(executed));
+    emit8(0x5B);
+    emit8(0xC3);
+}
+
+void Jit::emit8(std::uint8_t value)
+{
+    code[codeUsed++] = value;
+}
+
+void Jit::emit16(std::uint16_t value)
+{
+    emit8(value & 0xFF);
+    emit8(value >> 8);
+}
+
+void Jit::emit32(std::uint32_t value)
+{
+    emit16(value & 0xFFFF);
+    emit16(value >> 16);
+}
+
+void Jit::emit64(std::uint64_t value)
+{
+    emit32(value & 0xFFFFFFFF);
+    emit32(value >> 32);
+}
+
+void Jit::emitModRM(std::uint8_t reg, std::int32_t offset)
+{
+    // [rbx + disp32]
+    emit8(0x80 | reg << 3 | RBX);
+    emit32(static_cast<std::uint32_t>(offset));
+}
+
+std::int32_t Jit::registerOffset(int index) const
+{
+    return vOffset + index;
+}
+
+bool Jit::interpret(Chip8* chip8, std::uint32_t packed)
+{
+    Instruction in;
+    in.op = static_cast<Op>(packed & 0xFF);
+    in.x = packed >> 8 & 0xFF;
+    in.y = packed >> 16 & 0xFF;
+    in.kk = packed >> 24 & 0xFF;
+
+    const unsigned int before = chip8->jit->generation;
+    (chip8->*chip8->core->handlers[static_cast<int>(in.op)])(in);
+    return chip8->jit->generation != before;
+}
+
+#endif
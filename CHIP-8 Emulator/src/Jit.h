@@ -0,0 +1,85 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "Instruction.h"
+#include "Quirks.h"
+
+// The recompiler emits x86-64 System V code and needs mmap for executable
+// memory, so it is only built for Linux on x86-64.
+#if defined(__linux__) && defined(__x86_64__)
+#define CHIP8_JIT 1
+#else
+#define CHIP8_JIT 0
+#endif
+
+#if CHIP8_JIT
+
+class Chip8;
+
+// Translates basic blocks of CHIP-8 code into native x86-64 code. Simple
+// ALU, load, skip and jump instructions are emitted inline against the
+// Chip8 object; everything else calls back into the interpreter handlers.
+class Jit
+{
+public:
+    Jit(Chip8& chip8);
+    ~Jit();
+
+    bool isAvailable() const;
+    void run(Chip8& chip8, int cycles);
+    void invalidate(std::uint16_t address);
+    void clear();
+
+private:
+    // Returns the number of instructions executed
+    typedef int (*CompiledBlock)(Chip8* chip8);
+
+    struct Entry
+    {
+        CompiledBlock code = nullptr;
+        int length = 0;
+    };
+
+    const Entry& lookup(Chip8& chip8, std::uint16_t address);
+    void compile(Chip8& chip8, std::uint16_t address, Entry& entry);
+    // Sets the protection of the pages holding size bytes of the code
+    // buffer from offset. On failure the buffer is released and the JIT
+    // falls back to the interpreter.
+    bool protect(std::size_t offset, std::size_t size, int protection);
+    bool compileInline(const Instruction& in, std::uint16_t address, const Quirks& quirks);
+    void emitHelperCall(const Instruction& in, std::uint16_t address, int executed, bool terminal);
+    void emitSkip(bool equal, std::uint16_t address);
+    void emitReturn(int executed);
+    void erase(int start);
+
+    void emit8(std::uint8_t value);
+    void emit16(std::uint16_t value);
+    void emit32(std::uint32_t value);
+    void emit64(std::uint64_t value);
+    void emitModRM(std::uint8_t reg, std::int32_t offset);
+    std::int32_t registerOffset(int index) const;
+
+    static bool interpret(Chip8* chip8, std::uint32_t packed);
+
+    static const int MEMORY_SIZE = 4096;
+    static const int MAX_BLOCK_LENGTH = 64;
+    static const std::size_t CODE_SIZE = 256 * 1024;
+    static const std::size_t MAX_BLOCK_BYTES = MAX_BLOCK_LENGTH * 48;
+    static const std::size_t PAGE_SIZE = 4096;
+
+    std::uint8_t* code = nullptr;
+    std::size_t codeUsed = 0;
+    Entry entries[MEMORY_SIZE];
+    std::uint8_t coverage[MEMORY_SIZE] = {};
+    unsigned int generation = 0;
+
+    std::int32_t vOffset;
+    std::int32_t iOffset;
+    std::int32_t pcOffset;
+    std::int32_t delayTimerOffset;
+    std::int32_t soundTimerOffset;
+};
+
+#endif
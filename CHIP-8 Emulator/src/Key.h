@@ -1,24 +1,24 @@
 #pragma once
 
-#include <GLFW/glfw3.h>
-
+// Host key codes. Values match GLFW so Window can forward them unchanged.
 enum class Key
 {
-    Escape = GLFW_KEY_ESCAPE,
-    Alpha1 = GLFW_KEY_1,
-    Alpha2 = GLFW_KEY_2,
-    Alpha3 = GLFW_KEY_3,
-    Alpha4 = GLFW_KEY_4,
-    Q = GLFW_KEY_Q,
-    W = GLFW_KEY_W,
-    E = GLFW_KEY_E,
-    R = GLFW_KEY_R,
-    A = GLFW_KEY_A,
-    S = GLFW_KEY_S,
-    D = GLFW_KEY_D,
-    F = GLFW_KEY_F,
-    Z = GLFW_KEY_Z,
-    X = GLFW_KEY_X,
-    C = GLFW_KEY_C,
-    V = GLFW_KEY_V,
+    Escape = 256,
+    Backspace = 259,
+    Alpha1 = '1',
+    Alpha2 = '2',
+    Alpha3 = '3',
+    Alpha4 = '4',
+    Q = 'Q',
+    W = 'W',
+    E = 'E',
+    R = 'R',
+    A = 'A',
+    S = 'S',
+    D = 'D',
+    F = 'F',
+    Z = 'Z',
+    X = 'X',
+    C = 'C',
+    V = 'V',
 };
@@ -1,4 +1,3 @@
-#include <GLFW/glfw3.h>
 #include "Keypad.h"
 
 const KeypadMap Keypad::DEFAULT_MAP =
@@ -36,13 +35,32 @@ void Keypad::reset()
 
 void Keypad::updateKey(Key key, bool isPressed)
 {
-    if (map.find(key) != map.end())
+    auto mapping = DEFAULT_MAP.find(key);
+    if (mapping != DEFAULT_MAP.end())
     {
-        int kc = (int) map[key];
+        int kc = (int) mapping->second;
         keys[kc] = isPressed;
     }
 }
 
+void Keypad::setKeys(std::uint16_t mask)
+{
+    for (int i = 0; i < KEY_COUNT; ++i)
+    {
+        keys[i] = (mask >> i) & 1;
+    }
+}
+
+std::uint16_t Keypad::getKeys() const
+{
+    std::uint16_t mask = 0;
+    for (int i = 0; i < KEY_COUNT; ++i)
+    {
+        mask |= keys[i] ? 1 << i : 0;
+    }
+    return mask;
+}
+
 bool Keypad::isKeyPressed(int key) const
 {
     return keys[key];
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <cstdint>
 #include <unordered_map>
 #include "Key.h"
 
@@ -32,6 +33,8 @@ public:
 
     void reset();
     void updateKey(Key key, bool isPressed);
+    void setKeys(std::uint16_t keys);
+    std::uint16_t getKeys() const;
     bool isKeyPressed(int key) const;
     int getKey() const;
 
@@ -39,5 +42,4 @@ private:
     static const int KEY_COUNT = 16;
     static const KeypadMap DEFAULT_MAP;
     bool keys[KEY_COUNT];
-    KeypadMap map = DEFAULT_MAP;
 };
@@ -0,0 +1,44 @@
+#pragma once
+
+#include <cstdint>
+#include <type_traits>
+#include "Display.h"
+#include "Keypad.h"
+#include "PagedMemory.h"
+#include "Random.h"
+#include "Scheduler.h"
+
+// Everything a running program can observe apart from memory, in one
+// trivially copyable block so that saving or cloning a machine is a memcpy.
+// Aligned to a cache line so copies start on a line boundary.
+struct alignas(64) MachineState
+{
+    static const int REGISTER_COUNT = 16;
+    static const int STACK_SIZE = 16;
+
+    std::uint8_t V[REGISTER_COUNT];
+    std::uint16_t stack[STACK_SIZE];
+    std::uint16_t I = 0;
+    std::uint16_t pc = 0;
+    // Next free stack entry; calls and returns wrap around the 16 entries
+    std::uint8_t sp = 0;
+    std::uint8_t delayTimer = 0;
+    std::uint8_t soundTimer = 0;
+    Random random;
+    Keypad keypad;
+    Display display;
+};
+
+// A machine together with the contents of its memory and its position in
+// emulated time, as taken by Chip8::snapshot. The timer phase decides when
+// the next 60 Hz tick lands, so replays need it to be exact.
+struct alignas(64) Snapshot
+{
+    MachineState machine;
+    Scheduler scheduler;
+    std::uint8_t memory[PagedMemory::SIZE];
+};
+
+static_assert(std::is_trivially_copyable<MachineState>::value, "MachineState is copied with memcpy");
+static_assert(std::is_trivially_copyable<Scheduler>::value, "Scheduler is saved in snapshots");
+static_assert(std::is_trivially_copyable<Snapshot>::value, "Snapshot is copied with memcpy");
@@ -0,0 +1,252 @@
+#include "Movie.h"
+#include "Chip8.h"
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+
+namespace
+{
+    template <class T>
+    void write(std::ofstream& out, const T& value)
+    {
+        out.write(reinterpret_cast<const char*>(&value), sizeof(value));
+    }
+
+    template <class T>
+    bool read(std::ifstream& in, T& value)
+    {
+        return static_cast<bool>(in.read(reinterpret_cast<char*>(&value), sizeof(value)));
+    }
+
+    void writeVarint(std::ofstream& out, std::uint64_t value)
+    {
+        while (value >= 0x80)
+        {
+            out.put(static_cast<char>(value | 0x80));
+            value >>= 7;
+        }
+        out.put(static_cast<char>(value));
+    }
+
+    bool readVarint(std::ifstream& in, std::uint64_t& value)
+    {
+        value = 0;
+        for (int shift = 0; shift < 64; shift += 7)
+        {
+            const int byte = in.get();
+            if (byte == std::char_traits<char>::eof())
+            {
+                return false;
+            }
+            value |= static_cast<std::uint64_t>(byte & 0x7F) << shift;
+            if ((byte & 0x80) == 0)
+            {
+                return true;
+            }
+        }
+        return false;
+    }
+}
+
+const std::uint32_t Movie::MAGIC;
+const std::uint32_t Movie::VERSION;
+
+Movie::Movie(int snapshotInterval) :
+    snapshotInterval(snapshotInterval > 0 ? snapshotInterval : 1)
+{
+}
+
+void Movie::begin(Chip8& chip8, std::uint64_t seed)
+{
+    this->seed = seed;
+    quirks = chip8.getQuirks().bits();
+    events.clear();
+    keyframes.clear();
+    frameCount = 0;
+    frame = 0;
+    nextEvent = 0;
+
+    chip8.seed(seed);
+    keyframes.emplace_back();
+    keyframes.back().frame = 0;
+    chip8.snapshot(keyframes.back().snapshot);
+}
+
+void Movie::recordKeys(std::uint16_t keys)
+{
+    // Only the keys held when the frame starts matter
+    if (!events.empty() && events.back().frame == frameCount)
+    {
+        events.back().keys = keys;
+        return;
+    }
+    events.push_back({ frameCount, keys });
+}
+
+void Movie::endFrame(const Chip8& chip8)
+{
+    ++frameCount;
+    if (frameCount % snapshotInterval == 0)
+    {
+        keyframes.emplace_back();
+        keyframes.back().frame = frameCount;
+        chip8.snapshot(keyframes.back().snapshot);
+    }
+}
+
+bool Movie::seek(Chip8& chip8, std::uint64_t frame)
+{
+    if (frame > frameCount || keyframes.empty())
+    {
+        return false;
+    }
+
+    auto keyframe = std::upper_bound(keyframes.begin(), keyframes.end(), frame,
+        [](std::uint64_t value, const Keyframe& k) { return value < k.frame; });
+    --keyframe;
+
+    // The snapshot carries the clock rate and timer phase
+    chip8.setQuirks(Quirks::fromBits(quirks));
+    chip8.restore(keyframe->snapshot);
+    this->frame = keyframe->frame;
+    nextEvent = std::lower_bound(events.begin(), events.end(), this->frame,
+        [](const Event& e, std::uint64_t value) { return e.frame < value; }) - events.begin();
+
+    while (this->frame < frame)
+    {
+        playFrame(chip8);
+    }
+    return true;
+}
+
+bool Movie::playFrame(Chip8& chip8)
+{
+    if (frame >= frameCount)
+    {
+        return false;
+    }
+    while (nextEvent < events.size() && events[nextEvent].frame == frame)
+    {
+        chip8.setKeys(events[nextEvent].keys);
+        ++nextEvent;
+    }
+    chip8.runFrame();
+    ++frame;
+    return true;
+}
+
+std::uint64_t Movie::getFrame() const
+{
+    return frame;
+}
+
+std::uint64_t Movie::getFrameCount() const
+{
+    return frameCount;
+}
+
+std::uint64_t Movie::getSeed() const
+{
+    return seed;
+}
+
+// Snapshots are stored as raw Snapshot bytes, so movies load only into
+// builds with the same Snapshot layout
+bool Movie::save(const char* path) const
+{
+    std::ofstream out(path, std::ios::binary);
+    if (!out)
+    {
+        std::cerr << "Unable to write movie: " << path << ".\n";
+        return false;
+    }
+
+    write(out, MAGIC);
+    write(out, VERSION);
+    write(out, static_cast<std::uint32_t>(sizeof(Snapshot)));
+    write(out, seed);
+    write(out, static_cast<std::uint32_t>(quirks));
+    write(out, frameCount);
+
+    // Events as the number of frames since the previous one and the keys
+    write(out, static_cast<std::uint64_t>(events.size()));
+    std::uint64_t previous = 0;
+    for (const Event& event : events)
+    {
+        writeVarint(out, event.frame - previous);
+        write(out, event.keys);
+        previous = event.frame;
+    }
+    write(out, static_cast<std::uint64_t>(keyframes.size()));
+    for (const Keyframe& keyframe : keyframes)
+    {
+        write(out, keyframe.frame);
+        write(out, keyframe.snapshot);
+    }
+    return true;
+}
+
+bool Movie::load(const char* path)
+{
+    std::ifstream in(path, std::ios::binary);
+    if (!in)
+    {
+        std::cerr << "Unable to open movie: " << path << ".\n";
+        return false;
+    }
+
+    // Counts are checked against the bytes left so a corrupt header cannot
+    // ask for more memory than the file could describe
+    in.seekg(0, std::ios::end);
+    const std::uint64_t fileSize = static_cast<std::uint64_t>(in.tellg());
+    in.seekg(0, std::ios::beg);
+    auto remaining = [&in, fileSize]() { return fileSize - static_cast<std::uint64_t>(in.tellg()); };
+
+    std::uint32_t magic = 0;
+    std::uint32_t version = 0;
+    std::uint32_t snapshotSize = 0;
+    if (!read(in, magic) || !read(in, version) || !read(in, snapshotSize) ||
+        magic != MAGIC || version != VERSION || snapshotSize != sizeof(Snapshot))
+    {
+        std::cerr << "Not a movie of this version: " << path << ".\n";
+        return false;
+    }
+
+    std::uint32_t quirkBits = 0;
+    std::uint64_t eventCount = 0;
+    std::uint64_t keyframeCount = 0;
+    bool ok = read(in, seed) && read(in, quirkBits) && read(in, frameCount) && read(in, eventCount);
+    // An event takes at least a one-byte delta and the keys
+    ok = ok && eventCount <= remaining() / (1 + sizeof(std::uint16_t));
+    events.resize(ok ? static_cast<std::size_t>(eventCount) : 0);
+    std::uint64_t previous = 0;
+    for (Event& event : events)
+    {
+        std::uint64_t delta = 0;
+        ok = ok && readVarint(in, delta) && read(in, event.keys) && delta <= frameCount - previous;
+        event.frame = previous + delta;
+        previous = event.frame;
+    }
+    ok = ok && read(in, keyframeCount) && keyframeCount <= remaining() / (sizeof(std::uint64_t) + sizeof(Snapshot));
+    keyframes.resize(ok ? static_cast<std::size_t>(keyframeCount) : 0);
+    for (std::size_t i = 0; i < keyframes.size(); ++i)
+    {
+        // Seeking needs a keyframe for frame 0 and the rest in order
+        Keyframe& keyframe = keyframes[i];
+        ok = ok && read(in, keyframe.frame) && read(in, keyframe.snapshot) && keyframe.frame <= frameCount &&
+            (i == 0 ? keyframe.frame == 0 : keyframe.frame > keyframes[i - 1].frame);
+    }
+    if (!ok || keyframes.empty())
+    {
+        std::cerr << "Truncated or corrupt movie: " << path << ".\n";
+        events.clear();
+        keyframes.clear();
+        frameCount = 0;
+        return false;
+    }
+
+    quirks = quirkBits;
+    frame = 0;
+    nextEvent = 0;
+    return true;
+}
@@ -0,0 +1,68 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "MachineState.h"
+
+class Chip8;
+
+// Keypad input of a run, stamped with the frame it was applied before, and
+// the seed and starting state needed to replay it exactly. Snapshots taken
+// every snapshotInterval frames let playback seek without running from the
+// first frame.
+class Movie
+{
+public:
+    // Ten seconds at 60 frames per second
+    static const int DEFAULT_SNAPSHOT_INTERVAL = 600;
+
+    explicit Movie(int snapshotInterval = DEFAULT_SNAPSHOT_INTERVAL);
+
+    // Seeds the machine and starts recording from its current state. Key
+    // changes reach the movie through Chip8::setMovie; call endFrame after
+    // every frame the machine runs.
+    void begin(Chip8& chip8, std::uint64_t seed);
+    void recordKeys(std::uint16_t keys);
+    void endFrame(const Chip8& chip8);
+
+    // Puts the machine in the state it had before the given frame ran.
+    // Returns false if the movie is shorter.
+    bool seek(Chip8& chip8, std::uint64_t frame);
+    // Runs the next frame of the movie. Returns false at the end.
+    bool playFrame(Chip8& chip8);
+
+    std::uint64_t getFrame() const;
+    std::uint64_t getFrameCount() const;
+    std::uint64_t getSeed() const;
+
+    bool save(const char* path) const;
+    bool load(const char* path);
+
+private:
+    struct Event
+    {
+        std::uint64_t frame;
+        std::uint16_t keys;
+    };
+
+    struct Keyframe
+    {
+        std::uint64_t frame;
+        Snapshot snapshot;
+    };
+
+    static const std::uint32_t MAGIC = 0x564D3843;   // "C8MV"
+    static const std::uint32_t VERSION = 3;
+
+    int snapshotInterval;
+    std::uint64_t seed = 0;
+    unsigned int quirks = 0;
+    std::vector<Event> events;
+    std::vector<Keyframe> keyframes;
+    std::uint64_t frameCount = 0;
+
+    // Frame about to run, and the first event at or after it
+    std::uint64_t frame = 0;
+    std::size_t nextEvent = 0;
+};
@@ -0,0 +1,110 @@
+#include "NativeProgram.h"
+
+bool NativeContext::interpret(std::uint32_t packed)
+{
+    Instruction in;
+    in.op = static_cast<Op>(packed & 0xFF);
+    in.x = packed >> 8 & 0xFF;
+    in.y = packed >> 16 & 0xFF;
+    in.kk = packed >> 24 & 0xFF;
+
+    const unsigned int before = chip8.native->generation;
+    (chip8.*chip8.core->handlers[static_cast<int>(in.op)])(in);
+    return chip8.native->generation != before;
+}
+
+NativeRunner::NativeRunner(const NativeProgram& program) :
+    program(program)
+{
+}
+
+void NativeRunner::run(Chip8& chip8, int cycles)
+{
+    if (!verified)
+    {
+        verify(chip8);
+    }
+
+    NativeContext context(chip8);
+    while (cycles > 0)
+    {
+        const NativeBlockInfo* block = chip8.state.pc < MEMORY_SIZE ? entries[chip8.state.pc] : nullptr;
+
+        // Computed jumps, overwritten code, a pc past the end of memory and
+        // budgets shorter than the block are handled one instruction at a
+        // time.
+        if (block == nullptr || block->length > cycles)
+        {
+            chip8.executeOpcode();
+            --cycles;
+            continue;
+        }
+        cycles -= block->function(context);
+    }
+}
+
+void NativeRunner::invalidate(std::uint16_t address)
+{
+    if (address >= MEMORY_SIZE || coverage[address] == 0)
+    {
+        return;
+    }
+
+    int first = address - 2 * MAX_BLOCK_LENGTH + 1;
+    for (int start = first < 0 ? 0 : first; start <= address; ++start)
+    {
+        if (entries[start] != nullptr && address < start + 2 * entries[start]->length)
+        {
+            erase(start);
+        }
+    }
+    ++generation;
+}
+
+void NativeRunner::clear()
+{
+    // Memory was reset or reloaded; check it against the ROM again on
+    // the next run.
+    for (int start = 0; start < MEMORY_SIZE; ++start)
+    {
+        entries[start] = nullptr;
+        coverage[start] = 0;
+    }
+    verified = false;
+    ++generation;
+}
+
+void NativeRunner::verify(const Chip8& chip8)
+{
+    verified = true;
+    if (program.quirks != chip8.quirks.bits() || program.romSize > MEMORY_SIZE - PROGRAM_START)
+    {
+        return;
+    }
+    for (std::size_t i = 0; i < program.romSize; ++i)
+    {
+        if (chip8.memory.read(PROGRAM_START + i) != program.rom[i])
+        {
+            return;
+        }
+    }
+
+    for (std::size_t i = 0; i < program.blockCount; ++i)
+    {
+        const NativeBlockInfo& block = program.blocks[i];
+        entries[block.start] = &block;
+        for (int j = block.start; j < block.start + 2 * block.length; ++j)
+        {
+            ++coverage[j];
+        }
+    }
+}
+
+void NativeRunner::erase(int start)
+{
+    for (int i = start; i < start + 2 * entries[start]->length; ++i)
+    {
+        --coverage[i];
+    }
+    entries[start] = nullptr;
+}
@@ -0,0 +1,83 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include "Chip8.h"
+
+// View of a Chip8 handed to statically recompiled code. The references
+// let the C++ compiler keep registers in host registers across a block.
+class NativeContext
+{
+public:
+    explicit NativeContext(Chip8& chip8) :
+        V(chip8.state.V),
+        I(chip8.state.I),
+        pc(chip8.state.pc),
+        delayTimer(chip8.state.delayTimer),
+        soundTimer(chip8.state.soundTimer),
+        chip8(chip8)
+    {
+    }
+
+    // Runs one instruction through the interpreter. Returns true if it
+    // stored into recompiled code, in which case the block must stop.
+    bool interpret(std::uint32_t packed);
+
+    std::uint8_t* V;
+    std::uint16_t& I;
+    std::uint16_t& pc;
+    std::uint8_t& delayTimer;
+    std::uint8_t& soundTimer;
+
+private:
+    Chip8& chip8;
+};
+
+// Returns the number of instructions executed
+typedef int (*NativeBlock)(NativeContext& context);
+
+struct NativeBlockInfo
+{
+    std::uint16_t start;
+    std::uint16_t length;
+    NativeBlock function;
+};
+
+// A ROM translated ahead of time by the recompiler tool, for the quirks
+// given by Quirks::bits()
+struct NativeProgram
+{
+    const std::uint8_t* rom;
+    std::size_t romSize;
+    const NativeBlockInfo* blocks;
+    std::size_t blockCount;
+    unsigned int quirks;
+};
+
+// Runs the recompiled blocks of a NativeProgram while memory still holds
+// the ROM they were generated from, and interprets everywhere else.
+class NativeRunner
+{
+public:
+    explicit NativeRunner(const NativeProgram& program);
+
+    void run(Chip8& chip8, int cycles);
+    void invalidate(std::uint16_t address);
+    void clear();
+
+private:
+    void verify(const Chip8& chip8);
+    void erase(int start);
+
+    static const int MEMORY_SIZE = 4096;
+    static const int PROGRAM_START = 512;
+    static const int MAX_BLOCK_LENGTH = 64;
+
+    const NativeProgram& program;
+    bool verified = false;
+    const NativeBlockInfo* entries[MEMORY_SIZE] = {};
+    std::uint8_t coverage[MEMORY_SIZE] = {};
+    unsigned int generation = 0;
+
+    friend class NativeContext;
+};
@@ -0,0 +1,176 @@
+#include "PagedMemory.h"
+#include <algorithm>
+#include <cstring>
+#include <mutex>
+#include <unordered_map>
+
+const int MemoryImage::SIZE;
+
+namespace
+{
+    // Live images by a hash of their contents
+    std::mutex internLock;
+    std::unordered_multimap<std::uint64_t, std::weak_ptr<const MemoryImage>> interned;
+
+    std::uint64_t hashBytes(const std::uint8_t* bytes)
+    {
+        // FNV-1a
+        std::uint64_t hash = 14695981039346656037ULL;
+        for (int i = 0; i < MemoryImage::SIZE; ++i)
+        {
+            hash = (hash ^ bytes[i]) * 1099511628211ULL;
+        }
+        return hash;
+    }
+}
+
+PagedMemory::PagedMemory()
+{
+    static const std::shared_ptr<const MemoryImage> zeros = []()
+    {
+        std::uint8_t bytes[SIZE] = {};
+        return intern(bytes);
+    }();
+    setImage(zeros);
+}
+
+PagedMemory::PagedMemory(const PagedMemory& other)
+{
+    std::fill(isPrivate, isPrivate + PAGE_COUNT, false);
+    *this = other;
+}
+
+PagedMemory& PagedMemory::operator=(const PagedMemory& other)
+{
+    if (this == &other)
+    {
+        return *this;
+    }
+    setImage(other.image);
+    for (int page = 0; page < PAGE_COUNT; ++page)
+    {
+        if (other.isPrivate[page])
+        {
+            std::memcpy(makePrivate(page), other.pages[page], PAGE_SIZE);
+        }
+    }
+    hash = other.hash;
+    return *this;
+}
+
+std::shared_ptr<const MemoryImage> PagedMemory::intern(const std::uint8_t* bytes)
+{
+    const std::uint64_t hash = hashBytes(bytes);
+    std::lock_guard<std::mutex> lock(internLock);
+
+    auto range = interned.equal_range(hash);
+    for (auto it = range.first; it != range.second;)
+    {
+        std::shared_ptr<const MemoryImage> image = it->second.lock();
+        if (!image)
+        {
+            it = interned.erase(it);
+            continue;
+        }
+        if (std::memcmp(image->bytes, bytes, SIZE) == 0)
+        {
+            return image;
+        }
+        ++it;
+    }
+
+    // Drop the entries of images no machine holds any more. The image is
+    // allocated apart from its control block, so its bytes are freed as soon
+    // as the last machine lets go, even while an entry still points at it.
+    for (auto it = interned.begin(); it != interned.end();)
+    {
+        if (it->second.expired())
+        {
+            it = interned.erase(it);
+        }
+        else
+        {
+            ++it;
+        }
+    }
+
+    std::shared_ptr<MemoryImage> image(new MemoryImage);
+    std::memcpy(image->bytes, bytes, SIZE);
+    image->hash = 0;
+    for (int i = 0; i < SIZE; ++i)
+    {
+        image->hash += memoryHashTerm(i, bytes[i]);
+    }
+    interned.emplace(hash, image);
+    return image;
+}
+
+void PagedMemory::setImage(std::shared_ptr<const MemoryImage> image)
+{
+    this->image = std::move(image);
+    hash = this->image->hash;
+    for (int page = 0; page < PAGE_COUNT; ++page)
+    {
+        pages[page] = &this->image->bytes[page * PAGE_SIZE];
+        isPrivate[page] = false;
+    }
+}
+
+void PagedMemory::copyTo(std::uint8_t* bytes) const
+{
+    for (int page = 0; page < PAGE_COUNT; ++page)
+    {
+        std::memcpy(bytes + page * PAGE_SIZE, pages[page], PAGE_SIZE);
+    }
+}
+
+bool PagedMemory::pageEquals(int page, const std::uint8_t* bytes) const
+{
+    return std::memcmp(pages[page], bytes, PAGE_SIZE) == 0;
+}
+
+void PagedMemory::writePage(int page, const std::uint8_t* bytes)
+{
+    const int start = page * PAGE_SIZE;
+    for (int i = 0; i < PAGE_SIZE; ++i)
+    {
+        hash += memoryHashTerm(start + i, bytes[i]) - memoryHashTerm(start + i, pages[page][i]);
+    }
+
+    const std::uint8_t* shared = &image->bytes[start];
+    if (std::memcmp(shared, bytes, PAGE_SIZE) == 0)
+    {
+        pages[page] = shared;
+        isPrivate[page] = false;
+        return;
+    }
+    std::uint8_t* copy = isPrivate[page] ? owned[page]->bytes : makePrivate(page);
+    std::memcpy(copy, bytes, PAGE_SIZE);
+}
+
+int PagedMemory::getPrivatePageCount() const
+{
+    return static_cast<int>(std::count(isPrivate, isPrivate + PAGE_COUNT, true));
+}
+
+void PagedMemory::write(int address, std::uint8_t value)
+{
+    address &= SIZE - 1;
+    const int page = address / PAGE_SIZE;
+    std::uint8_t* bytes = isPrivate[page] ? owned[page]->bytes : makePrivate(page);
+    std::uint8_t& byte = bytes[address % PAGE_SIZE];
+    hash += memoryHashTerm(address, value) - memoryHashTerm(address, byte);
+    byte = value;
+}
+
+std::uint8_t* PagedMemory::makePrivate(int page)
+{
+    if (!owned[page])
+    {
+        owned[page].reset(new Page());
+    }
+    std::memcpy(owned[page]->bytes, pages[page], PAGE_SIZE);
+    pages[page] = owned[page]->bytes;
+    isPrivate[page] = true;
+    return owned[page]->bytes;
+}
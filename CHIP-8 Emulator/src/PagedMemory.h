@@ -0,0 +1,77 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include "StateHash.h"
+
+// Contents of the whole address space, shared read-only by every machine
+// that starts from it.
+struct MemoryImage
+{
+    static const int SIZE = 4096;
+
+    std::uint8_t bytes[SIZE];
+    // Sum of memoryHashTerm over every byte
+    std::uint64_t hash;
+};
+
+// Address space split into pages that point into a shared MemoryImage until
+// their first write, which gives the machine a private copy of that page.
+// Machines running the same program share the font and ROM, and copying
+// one duplicates only the pages it wrote.
+class PagedMemory
+{
+public:
+    static const int SIZE = MemoryImage::SIZE;
+    static const int PAGE_SIZE = 256;
+    static const int PAGE_COUNT = SIZE / PAGE_SIZE;
+
+    PagedMemory();
+    PagedMemory(const PagedMemory& other);
+    PagedMemory& operator=(const PagedMemory& other);
+
+    // Returns the shared image holding these SIZE bytes, creating it when no
+    // live image has the same contents
+    static std::shared_ptr<const MemoryImage> intern(const std::uint8_t* bytes);
+
+    // Points every page back at image, dropping private copies
+    void setImage(std::shared_ptr<const MemoryImage> image);
+    void copyTo(std::uint8_t* bytes) const;
+    bool pageEquals(int page, const std::uint8_t* bytes) const;
+    // Replaces a whole page, sharing the image again when it matches
+    void writePage(int page, const std::uint8_t* bytes);
+    int getPrivatePageCount() const;
+    // Hash of the contents, kept up to date by every write
+    std::uint64_t getHash() const { return hash; }
+
+    // Addresses wrap at the end of the address space
+    std::uint8_t read(int address) const
+    {
+        address &= SIZE - 1;
+        return pages[address / PAGE_SIZE][address % PAGE_SIZE];
+    }
+
+    std::uint16_t readOpcode(int address) const
+    {
+        return static_cast<std::uint16_t>(read(address) << 8 | read(address + 1));
+    }
+
+    void write(int address, std::uint8_t value);
+
+private:
+    struct Page
+    {
+        std::uint8_t bytes[PAGE_SIZE];
+    };
+
+    std::uint8_t* makePrivate(int page);
+
+    std::shared_ptr<const MemoryImage> image;
+    // Where each page is read from: the image or the private copy
+    const std::uint8_t* pages[PAGE_COUNT];
+    // Private copies, kept across setImage so rewriting a page does not
+    // allocate again
+    std::unique_ptr<Page> owned[PAGE_COUNT];
+    bool isPrivate[PAGE_COUNT];
+    std::uint64_t hash = 0;
+};
@@ -0,0 +1,274 @@
+#include "Presenter.h"
+#include <cstdint>
+#include <iostream>
+
+const char* Presenter::vertexSource = R"glsl(
+    #version 150 core
+    in vec2 position;
+    //in vec3 color;
+    in vec2 texcoord;
+    //out vec3 Color;
+    out vec2 Texcoord;
+    void main()
+    {
+        //Color = color;
+        Texcoord = texcoord;
+        gl_Position = vec4(position, 0.0, 1.0);
+    }
+)glsl";
+
+const char* Presenter::fragmentSource = R"glsl(
+    #version 150 core
+    //in vec3 Color;
+    in vec2 Texcoord;
+    out vec4 outColor;
+    // Each row is packed into 32-bit texels, leftmost pixel in the high bit
+    uniform usampler2D tex;
+    uniform vec3 foreground;
+    uniform vec3 background;
+    void main()
+    {
+        ivec2 size = textureSize(tex, 0) * ivec2(32, 1);
+        ivec2 pixel = min(ivec2(Texcoord * vec2(size)), size - 1);
+        uint word = texelFetch(tex, ivec2(pixel.x / 32, pixel.y), 0).r;
+        bool lit = ((word >> uint(31 - pixel.x % 32)) & 1u) != 0u;
+        outColor = vec4(lit ? foreground : background, 1.0);
+    }
+)glsl";
+
+Presenter::Presenter(const Display& display)
+{
+    createBuffers();
+    createShaders();
+    createTexture(display);
+    createPixelBuffers();
+    setPalette(DEFAULT_FOREGROUND, DEFAULT_BACKGROUND);
+}
+
+Presenter::~Presenter()
+{
+    cleanUp();
+}
+
+void Presenter::upload(const Display& display, std::uint32_t dirtyRows)
+{
+    // Rows drawn and erased again within the frame are already on screen
+    int first = Display::HEIGHT;
+    int last = -1;
+    for (int y = 0; y < Display::HEIGHT; ++y)
+    {
+        if ((dirtyRows >> y) & 1 && display.getRow(y) != shown[y])
+        {
+            first = first < y ? first : y;
+            last = y;
+        }
+    }
+    if (last < 0)
+    {
+        return;
+    }
+
+    const int rows = last - first + 1;
+    if (!isStreaming)
+    {
+        pack(display, first, last, &words[0][0]);
+        glTexSubImage2D(GL_TEXTURE_2D, 0, 0, first, WORDS_PER_ROW, rows, GL_RED_INTEGER, GL_UNSIGNED_INT, words[first]);
+        return;
+    }
+
+    // The buffer used RING_SIZE uploads ago is normally long since copied
+    const int index = nextBuffer;
+    nextBuffer = (nextBuffer + 1) % RING_SIZE;
+    waitForBuffer(index);
+
+    pack(display, first, last, mapped[index]);
+    const std::uintptr_t offset = first * WORDS_PER_ROW * sizeof(std::uint32_t);
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, pixelBuffers[index]);
+    glTexSubImage2D(GL_TEXTURE_2D, 0, 0, first, WORDS_PER_ROW, rows, GL_RED_INTEGER, GL_UNSIGNED_INT, reinterpret_cast<const void*>(offset));
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+    fences[index] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+}
+
+std::uint64_t Presenter::getStallCount() const
+{
+    return stalls;
+}
+
+void Presenter::setPalette(std::uint32_t foreground, std::uint32_t background)
+{
+    glUseProgram(shaderProgram);
+    glUniform3f(glGetUniformLocation(shaderProgram, "foreground"),
+        ((foreground >> 16) & 0xFF) / 255.0f, ((foreground >> 8) & 0xFF) / 255.0f, (foreground & 0xFF) / 255.0f);
+    glUniform3f(glGetUniformLocation(shaderProgram, "background"),
+        ((background >> 16) & 0xFF) / 255.0f, ((background >> 8) & 0xFF) / 255.0f, (background & 0xFF) / 255.0f);
+}
+
+void Presenter::render()
+{
+    glClearColor(0.0f, 0.0f, 0.0f, 1.0f);
+    glClear(GL_COLOR_BUFFER_BIT);
+    glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, 0);
+}
+
+void Presenter::createBuffers()
+{
+    // Create VAO
+    glGenVertexArrays(1, &vao);
+    glBindVertexArray(vao);
+
+    // Create VBO
+    glGenBuffers(1, &vbo);
+    GLfloat vertices[] = {
+        -1.0f,  1.0f, 1.0f, 0.0f, 0.0f, 0.0f, 0.0f,
+         1.0f,  1.0f, 0.0f, 1.0f, 0.0f, 1.0f, 0.0f,
+         1.0f, -1.0f, 0.0f, 0.0f, 1.0f, 1.0f, 1.0f,
+        -1.0f, -1.0f, 1.0f, 1.0f, 1.0f, 0.0f, 1.0f
+    };
+    glBindBuffer(GL_ARRAY_BUFFER, vbo);
+    glBufferData(GL_ARRAY_BUFFER, sizeof(vertices), vertices, GL_STATIC_DRAW);
+
+    // Create EBO
+    glGenBuffers(1, &ebo);
+    GLuint elements[] = {
+        0, 1, 2,
+        2, 3, 0
+    };
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, ebo);
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(elements), elements, GL_STATIC_DRAW);
+}
+
+void Presenter::createShaders()
+{
+    // Create vertex shader
+    vertexShader = glCreateShader(GL_VERTEX_SHADER);
+    glShaderSource(vertexShader, 1, &vertexSource, NULL);
+    glCompileShader(vertexShader);
+
+    // Create fragment shader
+    fragmentShader = glCreateShader(GL_FRAGMENT_SHADER);
+    glShaderSource(fragmentShader, 1, &fragmentSource, NULL);
+    glCompileShader(fragmentShader);
+
+    // Create shader program
+    shaderProgram = glCreateProgram();
+    glAttachShader(shaderProgram, vertexShader);
+    glAttachShader(shaderProgram, fragmentShader);
+    glBindFragDataLocation(shaderProgram, 0, "outColor");
+    glLinkProgram(shaderProgram);
+    glUseProgram(shaderProgram);
+
+    // Position attribute
+    GLint posAttrib = glGetAttribLocation(shaderProgram, "position");
+    glEnableVertexAttribArray(posAttrib);
+    glVertexAttribPointer(posAttrib, 2, GL_FLOAT, GL_FALSE, 7 * sizeof(GLfloat), 0);
+
+    // Color attribute
+    GLint colAttrib = glGetAttribLocation(shaderProgram, "color");
+    glEnableVertexAttribArray(colAttrib);
+    glVertexAttribPointer(colAttrib, 3, GL_FLOAT, GL_FALSE, 7 * sizeof(GLfloat), (void*)(2 * sizeof(GLfloat)));
+
+    // Texture attribute
+    GLint texAttrib = glGetAttribLocation(shaderProgram, "texcoord");
+    glEnableVertexAttribArray(texAttrib);
+    glVertexAttribPointer(texAttrib, 2, GL_FLOAT, GL_FALSE, 7 * sizeof(GLfloat), (void*)(5 * sizeof(GLfloat)));
+}
+
+void Presenter::createTexture(const Display& display)
+{
+    glActiveTexture(GL_TEXTURE0);
+    glGenTextures(1, &texture);
+    glBindTexture(GL_TEXTURE_2D, texture);
+    pack(display, 0, Display::HEIGHT - 1, &words[0][0]);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_R32UI, WORDS_PER_ROW, Display::HEIGHT, 0, GL_RED_INTEGER, GL_UNSIGNED_INT, words);
+    glUniform1i(glGetUniformLocation(shaderProgram, "tex"), 0);
+
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+}
+
+void Presenter::createPixelBuffers()
+{
+    if (!GLEW_VERSION_4_4 && !GLEW_ARB_buffer_storage)
+    {
+        std::cerr << "Persistent buffer mapping unavailable; uploading from client memory.\n";
+        return;
+    }
+
+    // Coherent, so writes are visible to the copy without a flush
+    const GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+    glGenBuffers(RING_SIZE, pixelBuffers);
+    isStreaming = true;
+    for (int i = 0; i < RING_SIZE; ++i)
+    {
+        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, pixelBuffers[i]);
+        glBufferStorage(GL_PIXEL_UNPACK_BUFFER, sizeof(words), nullptr, flags);
+        mapped[i] = static_cast<std::uint32_t*>(glMapBufferRange(GL_PIXEL_UNPACK_BUFFER, 0, sizeof(words), flags));
+        isStreaming = isStreaming && mapped[i] != nullptr;
+    }
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+
+    if (!isStreaming)
+    {
+        std::cerr << "Pixel buffer mapping failed; uploading from client memory.\n";
+    }
+}
+
+void Presenter::waitForBuffer(int index)
+{
+    if (!fences[index])
+    {
+        return;
+    }
+    if (glClientWaitSync(fences[index], 0, 0) == GL_TIMEOUT_EXPIRED)
+    {
+        ++stalls;
+        while (glClientWaitSync(fences[index], GL_SYNC_FLUSH_COMMANDS_BIT, FENCE_TIMEOUT) == GL_TIMEOUT_EXPIRED)
+        {
+        }
+    }
+    glDeleteSync(fences[index]);
+    fences[index] = nullptr;
+}
+
+void Presenter::pack(const Display& display, int first, int last, std::uint32_t* out)
+{
+    for (int y = first; y <= last; ++y)
+    {
+        const std::uint64_t row = display.getRow(y);
+        shown[y] = row;
+        for (int word = 0; word < WORDS_PER_ROW; ++word)
+        {
+            out[y * WORDS_PER_ROW + word] = static_cast<std::uint32_t>(row >> (Display::WIDTH - 32 - 32 * word));
+        }
+    }
+}
+
+void Presenter::cleanUp()
+{
+    for (int i = 0; i < RING_SIZE; ++i)
+    {
+        if (fences[i])
+        {
+            glDeleteSync(fences[i]);
+        }
+        if (mapped[i])
+        {
+            glBindBuffer(GL_PIXEL_UNPACK_BUFFER, pixelBuffers[i]);
+            glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER);
+        }
+    }
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+    if (pixelBuffers[0])
+    {
+        glDeleteBuffers(RING_SIZE, pixelBuffers);
+    }
+    glDeleteTextures(1, &texture);
+    glDeleteProgram(shaderProgram);
+    glDeleteShader(vertexShader);
+    glDeleteShader(fragmentShader);
+    glDeleteBuffers(1, &ebo);
+    glDeleteBuffers(1, &vbo);
+    glDeleteVertexArrays(1, &vao);
+}
@@ -0,0 +1,72 @@
+#pragma once
+
+#include <GL/glew.h>
+#include "Display.h"
+
+// Draws a Display framebuffer as a fullscreen textured quad. Rows are
+// uploaded bit-packed into an integer texture and the fragment shader
+// picks the colours, so a frame costs 256 bytes and palette changes are
+// a uniform update. Uploads are staged through a ring of persistently
+// mapped pixel buffers, so writing the next frame never waits for the GPU
+// to finish copying the last one. Needs a current OpenGL context, so it is
+// created by the host after the Window.
+class Presenter
+{
+public:
+    Presenter(const Display& display);
+    ~Presenter();
+
+    // Uploads the rows in dirtyRows that differ from the texture, as one
+    // span from the first to the last; nothing if none do
+    void upload(const Display& display, std::uint32_t dirtyRows = Display::ALL_ROWS);
+    void render();
+    // Colours of lit and unlit pixels as 0xRRGGBB
+    void setPalette(std::uint32_t foreground, std::uint32_t background);
+
+    // Uploads that found every pixel buffer still in use by the GPU
+    std::uint64_t getStallCount() const;
+
+    static const std::uint32_t DEFAULT_FOREGROUND = 0xFFFFFF;
+    static const std::uint32_t DEFAULT_BACKGROUND = 0x000000;
+
+private:
+    void createBuffers();
+    void createShaders();
+    void createTexture(const Display& display);
+    void createPixelBuffers();
+    void cleanUp();
+    // Copies rows first to last of the display into out, laid out as the
+    // whole texture
+    void pack(const Display& display, int first, int last, std::uint32_t* out);
+    // Blocks until the GPU has finished reading a pixel buffer
+    void waitForBuffer(int index);
+
+    static const char* vertexSource;
+    static const char* fragmentSource;
+
+    GLuint vao;
+    GLuint vbo;
+    GLuint ebo;
+    GLuint vertexShader;
+    GLuint fragmentShader;
+    GLuint shaderProgram;
+    GLuint texture;
+
+    static const int WORDS_PER_ROW = Display::WIDTH / 32;
+    // Client copy for the first upload and for drivers without persistent
+    // buffer mapping
+    std::uint32_t words[Display::HEIGHT][WORDS_PER_ROW];
+
+    // Pixel buffer ring; buffer i is free once fences[i] has signalled
+    static const int RING_SIZE = 3;
+    static const GLuint64 FENCE_TIMEOUT = 1000000000;
+    bool isStreaming = false;
+    int nextBuffer = 0;
+    GLuint pixelBuffers[RING_SIZE] = {};
+    std::uint32_t* mapped[RING_SIZE] = {};
+    GLsync fences[RING_SIZE] = {};
+    std::uint64_t stalls = 0;
+
+    // Rows as last uploaded to the texture
+    std::uint64_t shown[Display::HEIGHT];
+};
@@ -0,0 +1,108 @@
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include "Quirks.h"
+
+struct QuirkField
+{
+    const char* name;
+    bool Quirks::*flag;
+};
+
+// In bit order
+static const QuirkField FIELDS[] =
+{
+    { "shiftReadsVy", &Quirks::shiftReadsVy },
+    { "loadStoreIncrementsI", &Quirks::loadStoreIncrementsI },
+    { "jumpAddsVx", &Quirks::jumpAddsVx },
+    { "spritesWrap", &Quirks::spritesWrap },
+    { "logicResetsVF", &Quirks::logicResetsVF },
+};
+
+unsigned int Quirks::bits() const
+{
+    unsigned int bits = 0;
+    for (unsigned int i = 0; i < sizeof(FIELDS) / sizeof(FIELDS[0]); ++i)
+    {
+        if (this->*FIELDS[i].flag)
+        {
+            bits |= 1 << i;
+        }
+    }
+    return bits;
+}
+
+Quirks Quirks::fromBits(unsigned int bits)
+{
+    Quirks quirks;
+    for (unsigned int i = 0; i < sizeof(FIELDS) / sizeof(FIELDS[0]); ++i)
+    {
+        quirks.*FIELDS[i].flag = ((bits >> i) & 1) != 0;
+    }
+    return quirks;
+}
+
+Quirks Quirks::forProgram(const char* programPath)
+{
+    Quirks quirks;
+    const std::string path = std::string(programPath) + ".quirks";
+    std::ifstream input(path);
+    if (!input)
+    {
+        return quirks;
+    }
+
+    std::string line;
+    while (std::getline(input, line))
+    {
+        std::istringstream fields(line);
+        std::string name;
+        int value = 0;
+        if (!(fields >> name) || name[0] == '#')
+        {
+            continue;
+        }
+
+        const QuirkField* known = nullptr;
+        for (const QuirkField& field : FIELDS)
+        {
+            if (name == field.name)
+            {
+                known = &field;
+            }
+        }
+        if (!known)
+        {
+            std::cerr << "Ignoring unknown quirk in " << path << ": " << line << '\n';
+        }
+        else if (!(fields >> value))
+        {
+            std::cerr << "Ignoring quirk without a numeric value in " << path << ": " << line << '\n';
+        }
+        else
+        {
+            quirks.*known->flag = value != 0;
+        }
+    }
+    return quirks;
+}
+
+bool affectedByQuirks(Op op)
+{
+    switch (op)
+    {
+    case Op::OrVxVy:
+    case Op::AndVxVy:
+    case Op::XorVxVy:
+    case Op::ShrVx:
+    case Op::ShlVx:
+    case Op::JpV0:
+    case Op::Drw:
+    case Op::LdIVx:
+    case Op::LdVxI:
+        return true;
+    default:
+        return false;
+    }
+}
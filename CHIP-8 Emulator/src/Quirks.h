@@ -0,0 +1,56 @@
+#pragma once
+
+#include <utility>
+#include "Instruction.h"
+
+// Behaviours on which CHIP-8 interpreters disagree. Programs written for one
+// interpreter can break on another, so each program may bring a profile
+// naming the behaviours it expects.
+struct Quirks
+{
+    bool shiftReadsVy = false;          // 8XY6/8XYE shift Vy into Vx instead of shifting Vx
+    bool loadStoreIncrementsI = true;   // FX55/FX65 leave I past the last register
+    bool jumpAddsVx = false;            // BXNN jumps to XNN + VX instead of NNN + V0
+    bool spritesWrap = true;            // Sprites wrap around the screen edges instead of clipping
+    bool logicResetsVF = false;         // 8XY1/8XY2/8XY3 clear VF
+
+    unsigned int bits() const;
+    bool operator==(const Quirks& other) const { return bits() == other.bits(); }
+
+    // Reads "<program>.quirks", a list of "name 0|1" lines; programs without
+    // a profile get the defaults above.
+    static Quirks forProgram(const char* programPath);
+    // Inverse of bits()
+    static Quirks fromBits(unsigned int bits);
+};
+
+static const unsigned int QUIRK_COMBINATIONS = 1 << 5;
+
+// Compile-time form of Quirks, in the bit order of Quirks::bits(). Handlers
+// are instantiated per policy so they never test a flag at run time.
+template <unsigned int Bits>
+struct QuirkPolicy
+{
+    static constexpr bool shiftReadsVy = (Bits & 0x01) != 0;
+    static constexpr bool loadStoreIncrementsI = (Bits & 0x02) != 0;
+    static constexpr bool jumpAddsVx = (Bits & 0x04) != 0;
+    static constexpr bool spritesWrap = (Bits & 0x08) != 0;
+    static constexpr bool logicResetsVF = (Bits & 0x10) != 0;
+};
+
+// True for opcodes whose handlers are templated on a QuirkPolicy
+bool affectedByQuirks(Op op);
+
+template <class Factory, unsigned int... Bits>
+typename Factory::Result selectQuirkPolicy(const Quirks& quirks, std::integer_sequence<unsigned int, Bits...>)
+{
+    static const typename Factory::Result RESULTS[] = { Factory::template create<QuirkPolicy<Bits>>()... };
+    return RESULTS[quirks.bits()];
+}
+
+// Returns Factory::create<Policy>() for the policy matching quirks
+template <class Factory>
+typename Factory::Result selectQuirkPolicy(const Quirks& quirks)
+{
+    return selectQuirkPolicy<Factory>(quirks, std::make_integer_sequence<unsigned int, QUIRK_COMBINATIONS>());
+}
@@ -0,0 +1,12 @@
+#include "Random.h"
+
+const std::uint64_t Random::MULTIPLIER;
+const std::uint64_t Random::INCREMENT;
+
+void Random::seed(std::uint64_t value)
+{
+    state = 0;
+    next();
+    state += value;
+    next();
+}
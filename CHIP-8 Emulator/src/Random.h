@@ -0,0 +1,31 @@
+#pragma once
+
+#include <cstdint>
+
+// PCG32 generator (XSH RR output) for CXKK. Plain data so it can live in
+// MachineState: every machine draws from its own sequence, which snapshots
+// capture and which needs no locking when machines run on several threads.
+struct Random
+{
+    static const std::uint64_t MULTIPLIER = 6364136223846793005ULL;
+    static const std::uint64_t INCREMENT = 1442695040888963407ULL;
+
+    std::uint64_t state;
+
+    void seed(std::uint64_t value);
+
+    std::uint32_t next()
+    {
+        const std::uint64_t old = state;
+        state = old * MULTIPLIER + INCREMENT;
+        const std::uint32_t shifted = static_cast<std::uint32_t>(((old >> 18) ^ old) >> 27);
+        const std::uint32_t rotation = static_cast<std::uint32_t>(old >> 59);
+        return (shifted >> rotation) | (shifted << ((0u - rotation) & 31));
+    }
+
+    // Uniform over 0-255
+    std::uint8_t nextByte()
+    {
+        return static_cast<std::uint8_t>(next() >> 24);
+    }
+};
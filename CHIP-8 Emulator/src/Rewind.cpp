@@ -0,0 +1,264 @@
+#include "Rewind.h"
+#include "Chip8.h"
+#include <chrono>
+#include <cstring>
+
+namespace
+{
+    // Keyframes are encoded as a delta against an empty state
+    const std::uint8_t ZEROS[sizeof(Snapshot)] = {};
+
+    std::uint8_t* writeVarint(std::uint8_t* out, std::size_t value)
+    {
+        while (value >= 0x80)
+        {
+            *out++ = static_cast<std::uint8_t>(value | 0x80);
+            value >>= 7;
+        }
+        *out++ = static_cast<std::uint8_t>(value);
+        return out;
+    }
+
+    std::size_t readVarint(const std::uint8_t*& in)
+    {
+        std::size_t value = 0;
+        int shift = 0;
+        while (*in & 0x80)
+        {
+            value |= static_cast<std::size_t>(*in++ & 0x7F) << shift;
+            shift += 7;
+        }
+        value |= static_cast<std::size_t>(*in++) << shift;
+        return value;
+    }
+
+    bool sameWord(const std::uint8_t* a, const std::uint8_t* b)
+    {
+        std::uint64_t x;
+        std::uint64_t y;
+        std::memcpy(&x, a, sizeof(x));
+        std::memcpy(&y, b, sizeof(y));
+        return x == y;
+    }
+}
+
+const std::size_t Rewind::STATE_SIZE;
+
+Rewind::Rewind(std::size_t budgetBytes, int keyframeInterval) :
+    buffer(budgetBytes),
+    // Worst case is a header pair for every other byte
+    scratch(2 * STATE_SIZE + 16),
+    keyframeInterval(keyframeInterval > 0 ? keyframeInterval : 1)
+{
+}
+
+void Rewind::clear()
+{
+    entries.clear();
+    head = 0;
+    sinceKeyframe = 0;
+}
+
+void Rewind::record(const Chip8& chip8)
+{
+    const auto start = std::chrono::steady_clock::now();
+
+    chip8.snapshot(next);
+    const std::uint8_t* state = reinterpret_cast<const std::uint8_t*>(&next);
+    bool isKeyframe = entries.empty() || sinceKeyframe + 1 >= keyframeInterval;
+    std::size_t size = encode(state, isKeyframe ? ZEROS : reinterpret_cast<const std::uint8_t*>(&current));
+    if (!store(size, isKeyframe) && !isKeyframe)
+    {
+        // Making room dropped the keyframe this delta depends on
+        isKeyframe = true;
+        size = encode(state, ZEROS);
+        store(size, isKeyframe);
+    }
+    if (entries.empty())
+    {
+        // Not even a keyframe fits in the budget
+        return;
+    }
+    current = next;
+    sinceKeyframe = isKeyframe ? 0 : sinceKeyframe + 1;
+
+    ++recordedFrames;
+    rawBytes += STATE_SIZE;
+    encodedBytes += size;
+    encodeSeconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+bool Rewind::stepBack(Chip8& chip8)
+{
+    if (entries.size() < 2)
+    {
+        return false;
+    }
+
+    const Entry newest = entries.back();
+    entries.pop_back();
+    head = newest.offset;
+    if (newest.isKeyframe)
+    {
+        rebuildCurrent();
+    }
+    else
+    {
+        // XOR is its own inverse, so the delta that led to this frame also
+        // leads back from it
+        apply(&buffer[newest.offset], newest.size, reinterpret_cast<std::uint8_t*>(&current));
+        --sinceKeyframe;
+    }
+    // The keypad follows the player, not the recording; keys released
+    // while rewinding must not come back pressed
+    const std::uint16_t keys = chip8.getKeys();
+    chip8.restore(current);
+    chip8.setKeys(keys);
+    return true;
+}
+
+int Rewind::getFrameCount() const
+{
+    return static_cast<int>(entries.size());
+}
+
+std::size_t Rewind::getBytesUsed() const
+{
+    std::size_t used = 0;
+    for (const Entry& entry : entries)
+    {
+        used += entry.size;
+    }
+    return used;
+}
+
+double Rewind::getCompressionRatio() const
+{
+    return encodedBytes > 0 ? static_cast<double>(rawBytes) / encodedBytes : 0.0;
+}
+
+double Rewind::getAverageEncodeMicroseconds() const
+{
+    return recordedFrames > 0 ? encodeSeconds * 1e6 / recordedFrames : 0.0;
+}
+
+// Entries are pairs of varints, a run of unchanged bytes and a run of
+// changed ones, followed by the changed bytes XORed with base. Unchanged
+// bytes at the end are left implicit.
+std::size_t Rewind::encode(const std::uint8_t* state, const std::uint8_t* base)
+{
+    std::uint8_t* out = scratch.data();
+    std::size_t i = 0;
+    while (i < STATE_SIZE)
+    {
+        const std::size_t zeroStart = i;
+        while (i + 8 <= STATE_SIZE && sameWord(state + i, base + i))
+        {
+            i += 8;
+        }
+        while (i < STATE_SIZE && state[i] == base[i])
+        {
+            ++i;
+        }
+        if (i == STATE_SIZE)
+        {
+            break;
+        }
+
+        const std::size_t literalStart = i;
+        int unchanged = 0;
+        while (i < STATE_SIZE && unchanged < MIN_ZERO_RUN)
+        {
+            unchanged = state[i] == base[i] ? unchanged + 1 : 0;
+            ++i;
+        }
+        const std::size_t literalEnd = i - unchanged;
+        i = literalEnd;
+
+        out = writeVarint(out, literalStart - zeroStart);
+        out = writeVarint(out, literalEnd - literalStart);
+        for (std::size_t j = literalStart; j < literalEnd; ++j)
+        {
+            *out++ = state[j] ^ base[j];
+        }
+    }
+    return static_cast<std::size_t>(out - scratch.data());
+}
+
+void Rewind::apply(const std::uint8_t* data, std::size_t size, std::uint8_t* state)
+{
+    const std::uint8_t* end = data + size;
+    std::size_t position = 0;
+    while (data < end)
+    {
+        position += readVarint(data);
+        const std::size_t length = readVarint(data);
+        for (std::size_t j = 0; j < length; ++j)
+        {
+            state[position + j] ^= data[j];
+        }
+        data += length;
+        position += length;
+    }
+}
+
+// Returns false if the entry does not fit, or if it is a delta and making
+// room removed every older entry
+bool Rewind::store(std::size_t size, bool isKeyframe)
+{
+    if (size > buffer.size())
+    {
+        clear();
+        return false;
+    }
+    if (head + size > buffer.size())
+    {
+        // Entries left past head are older than any at the start
+        while (!entries.empty() && entries.front().offset >= head)
+        {
+            dropOldestKeyframe();
+        }
+        head = 0;
+    }
+    // Entries sit in the ring in recording order, so the oldest is the
+    // next one after head
+    while (!entries.empty() && entries.front().offset >= head && entries.front().offset < head + size)
+    {
+        dropOldestKeyframe();
+    }
+    if (entries.empty() && !isKeyframe)
+    {
+        return false;
+    }
+
+    std::memcpy(&buffer[head], scratch.data(), size);
+    entries.push_back({ head, size, isKeyframe });
+    head += size;
+    return true;
+}
+
+void Rewind::dropOldestKeyframe()
+{
+    entries.pop_front();
+    while (!entries.empty() && !entries.front().isKeyframe)
+    {
+        entries.pop_front();
+    }
+}
+
+void Rewind::rebuildCurrent()
+{
+    std::size_t keyframe = entries.size() - 1;
+    while (!entries[keyframe].isKeyframe)
+    {
+        --keyframe;
+    }
+
+    std::uint8_t* state = reinterpret_cast<std::uint8_t*>(&current);
+    std::memset(state, 0, STATE_SIZE);
+    for (std::size_t i = keyframe; i < entries.size(); ++i)
+    {
+        apply(&buffer[entries[i].offset], entries[i].size, state);
+    }
+    sinceKeyframe = static_cast<int>(entries.size() - 1 - keyframe);
+}
@@ -0,0 +1,75 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <vector>
+#include "MachineState.h"
+
+class Chip8;
+
+// Records a machine once per frame so it can be played backwards. Every
+// keyframeInterval frames the whole state is stored; the frames in between
+// are stored as their XOR with the previous frame, run-length encoded, since
+// little of memory and the framebuffer changes from one frame to the next.
+// Entries are packed into a ring buffer of fixed size and the oldest
+// keyframe is dropped, with its deltas, to make room.
+class Rewind
+{
+public:
+    static const int DEFAULT_KEYFRAME_INTERVAL = 60;
+
+    Rewind(std::size_t budgetBytes, int keyframeInterval = DEFAULT_KEYFRAME_INTERVAL);
+
+    void clear();
+    // Records the frame the machine has just run
+    void record(const Chip8& chip8);
+    // Puts the machine back to the frame recorded before the newest one and
+    // forgets the newest. The keypad keeps its live state. Returns false
+    // when there is no older frame.
+    bool stepBack(Chip8& chip8);
+
+    int getFrameCount() const;
+    std::size_t getBytesUsed() const;
+    // Cost of recording, over every frame recorded so far
+    double getCompressionRatio() const;
+    double getAverageEncodeMicroseconds() const;
+
+private:
+    struct Entry
+    {
+        std::size_t offset;
+        std::size_t size;
+        bool isKeyframe;
+    };
+
+    // Encodes state XOR base into scratch and returns its size
+    std::size_t encode(const std::uint8_t* state, const std::uint8_t* base);
+    // XORs an encoded entry into state
+    static void apply(const std::uint8_t* data, std::size_t size, std::uint8_t* state);
+    bool store(std::size_t size, bool isKeyframe);
+    void dropOldestKeyframe();
+    void rebuildCurrent();
+
+    static const std::size_t STATE_SIZE = sizeof(Snapshot);
+    // Unchanged bytes needed to end a literal run; shorter gaps cost more
+    // to encode than to copy
+    static const int MIN_ZERO_RUN = 4;
+
+    std::vector<std::uint8_t> buffer;
+    std::vector<std::uint8_t> scratch;
+    std::deque<Entry> entries;
+    std::size_t head = 0;
+    int keyframeInterval;
+    // Deltas recorded since the newest keyframe
+    int sinceKeyframe = 0;
+
+    // State of the newest entry, and the frame being recorded
+    Snapshot current;
+    Snapshot next;
+
+    std::uint64_t recordedFrames = 0;
+    std::uint64_t rawBytes = 0;
+    std::uint64_t encodedBytes = 0;
+    double encodeSeconds = 0.0;
+};
@@ -0,0 +1,61 @@
+#include "Scheduler.h"
+
+Scheduler::Scheduler()
+{
+    reset();
+}
+
+void Scheduler::setClockRate(int instructionsPerSecond)
+{
+    clockRate = instructionsPerSecond > 0 ? instructionsPerSecond : UNLIMITED;
+    untilTimer = clockRate;
+}
+
+int Scheduler::getClockRate() const
+{
+    return clockRate;
+}
+
+bool Scheduler::isUnlimited() const
+{
+    return clockRate == UNLIMITED;
+}
+
+int Scheduler::cyclesUntilTimer(int budget) const
+{
+    if (isUnlimited())
+    {
+        return budget;
+    }
+    const std::int64_t cycles = (untilTimer + TIMER_RATE - 1) / TIMER_RATE;
+    return cycles < budget ? static_cast<int>(cycles) : budget;
+}
+
+int Scheduler::advance(int executed)
+{
+    cycles += executed;
+    if (isUnlimited())
+    {
+        return 0;
+    }
+
+    int ticks = 0;
+    untilTimer -= static_cast<std::int64_t>(executed) * TIMER_RATE;
+    while (untilTimer <= 0)
+    {
+        untilTimer += clockRate;
+        ++ticks;
+    }
+    return ticks;
+}
+
+void Scheduler::reset()
+{
+    untilTimer = clockRate;
+    cycles = 0;
+}
+
+std::uint64_t Scheduler::getCycles() const
+{
+    return cycles;
+}
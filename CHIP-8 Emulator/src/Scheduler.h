@@ -0,0 +1,36 @@
+#pragma once
+
+#include <cstdint>
+
+// Tracks emulated time for a CPU running at a fixed instruction rate and the
+// 60 Hz timer domain. Time is kept in units of 1 / (60 * rate) seconds so an
+// instruction (60 units) and a timer period (rate units) are both exact.
+class Scheduler
+{
+public:
+    static const int UNLIMITED = 0;
+    static const int DEFAULT_CLOCK_RATE = 600;
+    static const int TIMER_RATE = 60;
+    // Instructions in a timer period when the clock is unlimited. Fixed
+    // rather than paced by host time, so runs are reproducible.
+    static const int UNLIMITED_FRAME_CYCLES = 10000;
+
+    Scheduler();
+
+    void setClockRate(int instructionsPerSecond);
+    int getClockRate() const;
+    bool isUnlimited() const;
+
+    // Instructions that can run before the next timer tick, at most budget
+    int cyclesUntilTimer(int budget) const;
+    // Accounts for executed instructions and returns the timer ticks now due
+    int advance(int cycles);
+    void reset();
+
+    std::uint64_t getCycles() const;
+
+private:
+    int clockRate = DEFAULT_CLOCK_RATE;
+    std::int64_t untilTimer = DEFAULT_CLOCK_RATE;
+    std::uint64_t cycles = 0;
+};
@@ -0,0 +1,27 @@
+#pragma once
+
+#include <cstdint>
+
+// Machine state is hashed as the sum of one term per byte of memory and
+// per framebuffer row, each term a mix of the position and the value. A
+// write replaces one term, so the hash follows the state without
+// rescanning it.
+
+// SplitMix64 finalizer
+inline std::uint64_t mixHash(std::uint64_t value)
+{
+    value += 0x9E3779B97F4A7C15ULL;
+    value = (value ^ (value >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    value = (value ^ (value >> 27)) * 0x94D049BB133111EBULL;
+    return value ^ (value >> 31);
+}
+
+inline std::uint64_t memoryHashTerm(int address, std::uint8_t value)
+{
+    return mixHash(static_cast<std::uint64_t>(address) << 8 | value);
+}
+
+inline std::uint64_t displayRowHashTerm(int y, std::uint64_t row)
+{
+    return mixHash(mixHash(row) + static_cast<std::uint64_t>(y));
+}
@@ -0,0 +1,76 @@
+#include "VisitedSet.h"
+
+VisitedSet::VisitedSet(std::size_t capacity) :
+    count(0)
+{
+    std::size_t size = 1;
+    while (size < capacity)
+    {
+        size <<= 1;
+    }
+    slots.reset(new std::atomic<std::uint64_t>[size]);
+    mask = size - 1;
+    clear();
+}
+
+VisitedSet::InsertResult VisitedSet::insert(std::uint64_t hash)
+{
+    const std::uint64_t value = key(hash);
+    std::size_t index = static_cast<std::size_t>(value) & mask;
+    for (std::size_t probe = 0; probe <= mask; ++probe)
+    {
+        std::atomic<std::uint64_t>& slot = slots[index];
+        std::uint64_t current = slot.load(std::memory_order_relaxed);
+        if (current == 0 && slot.compare_exchange_strong(current, value, std::memory_order_relaxed))
+        {
+            count.fetch_add(1, std::memory_order_relaxed);
+            return InsertResult::Inserted;
+        }
+        // A failed exchange leaves the winning value in current
+        if (current == value)
+        {
+            return InsertResult::AlreadyPresent;
+        }
+        index = (index + 1) & mask;
+    }
+    return InsertResult::Full;
+}
+
+bool VisitedSet::contains(std::uint64_t hash) const
+{
+    const std::uint64_t value = key(hash);
+    std::size_t index = static_cast<std::size_t>(value) & mask;
+    for (std::size_t probe = 0; probe <= mask; ++probe)
+    {
+        const std::uint64_t current = slots[index].load(std::memory_order_relaxed);
+        if (current == value)
+        {
+            return true;
+        }
+        if (current == 0)
+        {
+            return false;
+        }
+        index = (index + 1) & mask;
+    }
+    return false;
+}
+
+void VisitedSet::clear()
+{
+    for (std::size_t i = 0; i <= mask; ++i)
+    {
+        slots[i].store(0, std::memory_order_relaxed);
+    }
+    count.store(0, std::memory_order_relaxed);
+}
+
+std::size_t VisitedSet::size() const
+{
+    return count.load(std::memory_order_relaxed);
+}
+
+std::size_t VisitedSet::getCapacity() const
+{
+    return mask + 1;
+}
@@ -0,0 +1,41 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+// Set of state hashes shared by the threads of a search. Open addressing
+// with linear probing over a fixed table of atomics: an insert claims an
+// empty slot with a compare-and-swap, so threads never take a lock. The
+// table does not grow; size it for the states the search may visit.
+class VisitedSet
+{
+public:
+    enum class InsertResult
+    {
+        Inserted,
+        AlreadyPresent,
+        // No empty slot is left; the hash was not recorded
+        Full
+    };
+
+    // Capacity is rounded up to a power of two
+    explicit VisitedSet(std::size_t capacity);
+
+    InsertResult insert(std::uint64_t hash);
+    bool contains(std::uint64_t hash) const;
+    // Not safe while other threads insert
+    void clear();
+
+    std::size_t size() const;
+    std::size_t getCapacity() const;
+
+private:
+    // Zero marks an empty slot, so a zero hash is stored as another value
+    static std::uint64_t key(std::uint64_t hash) { return hash != 0 ? hash : 1; }
+
+    std::unique_ptr<std::atomic<std::uint64_t>[]> slots;
+    std::size_t mask;
+    std::atomic<std::size_t> count;
+};
@@ -2,6 +2,11 @@
 #include <GL/glew.h>
 #include "Window.h"
 
+static_assert(static_cast<int>(Key::Escape) == GLFW_KEY_ESCAPE, "Key must match GLFW key codes");
+static_assert(static_cast<int>(Key::Backspace) == GLFW_KEY_BACKSPACE, "Key must match GLFW key codes");
+static_assert(static_cast<int>(Key::Alpha1) == GLFW_KEY_1, "Key must match GLFW key codes");
+static_assert(static_cast<int>(Key::V) == GLFW_KEY_V, "Key must match GLFW key codes");
+
 Window::Window(int initialWidth, int initialHeight, const char* title)
 {
     init(initialWidth, initialHeight, title);
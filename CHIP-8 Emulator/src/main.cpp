@@ -1,37 +1,225 @@
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
 #include <iostream>
+#include <memory>
 #include <GL/glew.h>
 #include <GLFW/glfw3.h>
 #include "Chip8.h"
+#include "Presenter.h"
+#include "Window.h"
+#include "ExecutionProfile.h"
+#include "FrameTimer.h"
+#include "Movie.h"
+#include "Rewind.h"
 
 const char* programName = "Breakout (Brix hack) [David Winter, 1997].ch8";
 
+// State shared with the key handler through the window's user pointer
+struct Session
+{
+    Chip8* chip8;
+    Rewind* rewind;
+    Movie* movie;
+    bool isRewinding;
+    bool isPlaying;
+    bool isRecording;
+};
+
 static void handleKey(Window* window, Key key, bool isKeyPressed)
 {
-    Chip8* chip8 = static_cast<Chip8*>(window->getUserPointer());
+    Session* session = static_cast<Session*>(window->getUserPointer());
+    if (session->isPlaying)
+    {
+        // Input comes from the movie; Escape starts it over
+        if (key == Key::Escape && isKeyPressed)
+        {
+            session->movie->seek(*session->chip8, 0);
+        }
+        return;
+    }
     if (key == Key::Escape && isKeyPressed)
     {
-        chip8->reset();
-        chip8->loadProgram(programName);
+        session->chip8->reset();
+        session->chip8->loadProgram(programName);
+        if (session->rewind)
+        {
+            session->rewind->clear();
+        }
+        if (session->isRecording)
+        {
+            // The movie starts over with the program
+            session->movie->begin(*session->chip8, session->movie->getSeed());
+        }
+    }
+    else if (key == Key::Backspace)
+    {
+        // Held down, plays the recorded frames backwards
+        session->isRewinding = isKeyPressed && session->rewind != nullptr;
     }
     else
     {
-        chip8->updateKeypad(key, isKeyPressed);
+        session->chip8->updateKeypad(key, isKeyPressed);
     }
 }
 
-int main()
+int main(int argc, char** argv)
 {
+    // --profile <path> records opcode sequences for tools/SuperinstructionGen
+    // --clock <instructions per second> sets the CPU rate, 0 for unlimited
+    // --rewind <kilobytes> sets the memory kept for rewinding, 0 to disable
+    // --record <path> saves the input of the session as a movie
+    // --play <path> replays a movie instead of reading the keyboard
+    // --foreground, --background <RRGGBB> set the colours of the screen
+    const char* profilePath = nullptr;
+    const char* recordPath = nullptr;
+    const char* playPath = nullptr;
+    int clockRate = Scheduler::DEFAULT_CLOCK_RATE;
+    int rewindKilobytes = 4096;
+    std::uint32_t foreground = Presenter::DEFAULT_FOREGROUND;
+    std::uint32_t background = Presenter::DEFAULT_BACKGROUND;
+    for (int i = 1; i + 1 < argc; i += 2)
+    {
+        if (std::strcmp(argv[i], "--profile") == 0)
+        {
+            profilePath = argv[i + 1];
+        }
+        else if (std::strcmp(argv[i], "--clock") == 0)
+        {
+            clockRate = std::atoi(argv[i + 1]);
+        }
+        else if (std::strcmp(argv[i], "--rewind") == 0)
+        {
+            rewindKilobytes = std::atoi(argv[i + 1]);
+        }
+        else if (std::strcmp(argv[i], "--record") == 0)
+        {
+            recordPath = argv[i + 1];
+        }
+        else if (std::strcmp(argv[i], "--play") == 0)
+        {
+            playPath = argv[i + 1];
+        }
+        else if (std::strcmp(argv[i], "--foreground") == 0)
+        {
+            foreground = static_cast<std::uint32_t>(std::strtoul(argv[i + 1], nullptr, 16));
+        }
+        else if (std::strcmp(argv[i], "--background") == 0)
+        {
+            background = static_cast<std::uint32_t>(std::strtoul(argv[i + 1], nullptr, 16));
+        }
+        else
+        {
+            std::cerr << "Unknown option: " << argv[i] << '\n';
+        }
+    }
+
     Window window(640, 320, "CHIP-8 Emulator");
     window.setKeyHandler(handleKey);
 
     Chip8 chip8(programName);
-    window.setUserPointer(&chip8);
+    chip8.setClockRate(clockRate);
+    // A different game every run; tests seed a fixed value instead
+    chip8.seed(static_cast<std::uint64_t>(std::time(nullptr)));
+
+    Movie movie;
+    bool isPlaying = false;
+    if (playPath)
+    {
+        isPlaying = movie.load(playPath) && movie.seek(chip8, 0);
+    }
+    else if (recordPath)
+    {
+        movie.begin(chip8, static_cast<std::uint64_t>(std::time(nullptr)));
+        chip8.setMovie(&movie);
+    }
+
+    // Rewinding would make the movie disagree with the machine
+    std::unique_ptr<Rewind> rewind;
+    if (rewindKilobytes > 0 && !playPath && !recordPath)
+    {
+        rewind.reset(new Rewind(static_cast<std::size_t>(rewindKilobytes) * 1024));
+    }
+
+    Session session = { &chip8, rewind.get(), &movie, false, isPlaying, recordPath != nullptr };
+    window.setUserPointer(&session);
+
+    Presenter presenter(chip8.getDisplay());
+    presenter.setPalette(foreground, background);
+
+    ExecutionProfile profile;
+    if (profilePath)
+    {
+        chip8.setProfile(&profile);
+    }
 
+    FrameTimer frameTimer;
+    bool wasSoundOn = false;
     while (window.isOpen())
     {
-        chip8.update();
+        frameTimer.begin();
+        if (isPlaying)
+        {
+            if (movie.playFrame(chip8))
+            {
+                presenter.upload(chip8.getDisplay(), chip8.takeDirtyRows());
+            }
+        }
+        else if (session.isRewinding)
+        {
+            // One recorded frame per host frame, so rewinding runs at the
+            // speed the frames were played
+            if (rewind->stepBack(chip8))
+            {
+                presenter.upload(chip8.getDisplay(), chip8.takeDirtyRows());
+            }
+        }
+        else
+        {
+            if (chip8.runFrame())
+            {
+                presenter.upload(chip8.getDisplay(), chip8.takeDirtyRows());
+            }
+            if (rewind)
+            {
+                rewind->record(chip8);
+            }
+            if (recordPath)
+            {
+                movie.endFrame(chip8);
+            }
+        }
+        // No audio output yet; each tone is reported on the console
+        const bool isSoundOn = chip8.isSoundOn();
+        if (isSoundOn && !wasSoundOn)
+        {
+            std::cout << "beep\n";
+        }
+        wasSoundOn = isSoundOn;
+
+        presenter.render();
+        frameTimer.end();
         window.update();
     }
 
+    std::cout << "Frame time: " << frameTimer.getAverageMilliseconds() << " ms average, " << frameTimer.getDeviationMilliseconds()
+        << " ms deviation, " << frameTimer.getMaxMilliseconds() << " ms max over " << frameTimer.getFrameCount() << " frames, "
+        << presenter.getStallCount() << " upload stalls\n";
+
+    if (rewind)
+    {
+        std::cout << "Rewind: " << rewind->getFrameCount() << " frames in " << rewind->getBytesUsed() / 1024 << " KiB, "
+            << rewind->getCompressionRatio() << "x compression, " << rewind->getAverageEncodeMicroseconds() << " us per frame\n";
+    }
+
+    if (profilePath)
+    {
+        profile.save(profilePath);
+    }
+    if (recordPath)
+    {
+        movie.save(recordPath);
+    }
+
     return 0;
 }
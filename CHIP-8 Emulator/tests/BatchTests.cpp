@@ -0,0 +1,120 @@
+// Chip8Batch lanes must each follow the program exactly as a lone Chip8
+// with the same seed and keys does.
+
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include "../src/Chip8.h"
+#include "../src/Chip8Batch.h"
+#include "../src/NativeProgram.h"
+#include "Test.h"
+
+extern const NativeProgram selfModifyingProgram;
+
+static const int LANES = 8;
+static const int INSTRUCTIONS = 50000;
+static const int CLOCK_RATE = 1000;
+
+// Lanes differ in seed and held keys, so they diverge on CXKK and the key
+// skips and have to be regrouped
+static std::uint64_t laneSeed(int lane)
+{
+    return 1 + lane % 3;
+}
+
+static std::uint16_t laneKeys(int lane)
+{
+    return static_cast<std::uint16_t>(lane * 0x2D1B);
+}
+
+// Runs in uneven slices so that lanes regroup at different points
+template <class Machine>
+static void runSlices(Machine& machine, int instructions)
+{
+    int slice = 64;
+    for (int executed = 0; executed < instructions; executed += slice)
+    {
+        slice = slice * 7 % 997 + 1;
+        machine.run(slice);
+    }
+}
+
+// With a program given in before, the lanes first run that one for a
+// while and then load path over it
+static void checkLanes(const char* path, const Quirks& quirks = Quirks(), const char* before = nullptr)
+{
+    CHECK(std::ifstream(path).good());
+    Chip8Batch batch(LANES);
+    batch.setClockRate(CLOCK_RATE);
+    for (int lane = 0; lane < LANES; ++lane)
+    {
+        batch.seed(lane, laneSeed(lane));
+        for (int key = 0; key < 16; ++key)
+        {
+            batch.setKey(lane, key, (laneKeys(lane) >> key & 1) != 0);
+        }
+    }
+    if (before)
+    {
+        batch.loadProgram(before);
+        runSlices(batch, INSTRUCTIONS / 5);
+    }
+    batch.loadProgram(path);
+    batch.setQuirks(quirks);
+    runSlices(batch, INSTRUCTIONS);
+
+    for (int lane = 0; lane < LANES; ++lane)
+    {
+        Chip8 chip8;
+        chip8.setClockRate(CLOCK_RATE);
+        chip8.seed(laneSeed(lane));
+        chip8.setKeys(laneKeys(lane));
+        if (before)
+        {
+            chip8.loadProgram(before);
+            runSlices(chip8, INSTRUCTIONS / 5);
+        }
+        chip8.loadProgram(path);
+        chip8.setQuirks(quirks);
+        runSlices(chip8, INSTRUCTIONS);
+        if (chip8.getStateHash() != batch.getStateHash(lane))
+        {
+            std::cerr << path << ": lane " << lane << ", quirks " << quirks.bits() << " differs from Chip8.\n";
+            CHECK(false);
+        }
+    }
+}
+
+TEST(batchLanesMatchChip8OnRoms)
+{
+    for (const char* path : { BREAKOUT_ROM, IBM_ROM, KEYPAD_ROM, OPCODE_ROM })
+    {
+        checkLanes(path);
+    }
+}
+
+TEST(batchLanesMatchChip8ForEveryQuirkPolicy)
+{
+    for (unsigned int bits = 0; bits < QUIRK_COMBINATIONS; ++bits)
+    {
+        checkLanes(OPCODE_ROM, Quirks::fromBits(bits));
+    }
+}
+
+// Each lane writes its own copy of the code it runs
+TEST(batchLanesMatchChip8OnSelfModifyingCode)
+{
+    const char* path = writeProgram("batch.ch8", selfModifyingProgram.rom, selfModifyingProgram.romSize);
+    checkLanes(path);
+    std::remove(path);
+}
+
+// Loading a program over one that wrote to memory shares the program's
+// bytes again but keeps what each lane wrote elsewhere
+TEST(batchLanesMatchChip8AfterLoadingOverARunningProgram)
+{
+    const char* path = writeProgram("batch.ch8", selfModifyingProgram.rom, selfModifyingProgram.romSize);
+    checkLanes(IBM_ROM, Quirks(), path);
+    checkLanes(path, Quirks(), BREAKOUT_ROM);
+    std::remove(path);
+}
@@ -0,0 +1,143 @@
+// Differential tests: every dispatch engine must leave a machine in exactly
+// the state the switch interpreter does.
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <vector>
+#include "../src/Chip8.h"
+#include "../src/NativeProgram.h"
+#include "Test.h"
+
+// Recompiled from test_opcode.ch8 and from the program of
+// enginesMatchOnSelfModifyingCode by tools/Recompiler
+extern const NativeProgram opcodeProgram;
+extern const NativeProgram selfModifyingProgram;
+
+static const Dispatch ENGINES[] = { Dispatch::Table, Dispatch::Threaded, Dispatch::Block, Dispatch::Jit };
+
+static const int INSTRUCTIONS = 200000;
+// Engines run at most one timer period at a time; this is long enough for
+// the recompiled blocks above to run whole
+static const int CLOCK_RATE = 1000;
+
+// Runs in uneven slices so that slice ends fall inside blocks, and changes
+// the keys now and then so keypad waits and skips take both paths
+static std::uint64_t runProgram(const char* path, Dispatch dispatch, const Quirks& quirks,
+    const NativeProgram* native = nullptr)
+{
+    Chip8 chip8(path, dispatch);
+    chip8.setQuirks(quirks);
+    chip8.attachNativeProgram(native);
+    chip8.setClockRate(CLOCK_RATE);
+    chip8.seed(1);
+    int slice = 64;
+    for (int executed = 0; executed < INSTRUCTIONS; executed += slice)
+    {
+        slice = slice * 7 % 997 + 1;
+        chip8.run(slice);
+        chip8.setKeys(static_cast<std::uint16_t>(executed / 5000 * 0x2D1B));
+    }
+    return chip8.getStateHash();
+}
+
+static void checkEngines(const char* path, const Quirks& quirks = Quirks())
+{
+    CHECK(std::ifstream(path).good());
+    const std::uint64_t expected = runProgram(path, Dispatch::Switch, quirks);
+    for (Dispatch dispatch : ENGINES)
+    {
+        if (runProgram(path, dispatch, quirks) != expected)
+        {
+            std::cerr << path << ": engine " << static_cast<int>(dispatch) << ", quirks " << quirks.bits() <<
+                " differs from the switch interpreter.\n";
+            CHECK(false);
+        }
+    }
+}
+
+TEST(enginesMatchOnRoms)
+{
+    for (const char* path : { BREAKOUT_ROM, IBM_ROM, KEYPAD_ROM, OPCODE_ROM })
+    {
+        checkEngines(path);
+    }
+}
+
+TEST(enginesMatchForEveryQuirkPolicy)
+{
+    for (unsigned int bits = 0; bits < QUIRK_COMBINATIONS; ++bits)
+    {
+        checkEngines(OPCODE_ROM, Quirks::fromBits(bits));
+        checkEngines(BREAKOUT_ROM, Quirks::fromBits(bits));
+    }
+}
+
+// A loop that patches its own code: FX33 writes a digit into the byte of
+// the ADD at 0x212 and clobbers the jump after it, and FX55 puts the jump
+// back, all within the block that is running
+TEST(enginesMatchOnSelfModifyingCode)
+{
+    static const std::uint8_t PROGRAM[] =
+    {
+        0x60, 0x12,     // 200: V0 = 0x12
+        0x61, 0x06,     // 202: V1 = 0x06
+        0x62, 0x00,     // 204: V2 = 0
+        0x74, 0x17,     // 206: V4 += 0x17
+        0xA2, 0x13,     // 208: I = 0x213
+        0xF4, 0x33,     // 20A: BCD of V4 at 0x213..0x215
+        0xA2, 0x14,     // 20C: I = 0x214
+        0xF1, 0x55,     // 20E: restore 0x214..0x215 to JP 0x206
+        0x83, 0x44,     // 210: V3 += V4
+        0x73, 0x00,     // 212: V3 += hundreds digit
+        0x12, 0x06,     // 214: JP 0x206
+    };
+    const char* path = writeProgram("smc.ch8", PROGRAM, sizeof(PROGRAM));
+    Quirks quirks;
+    checkEngines(path, quirks);
+    quirks.loadStoreIncrementsI = !quirks.loadStoreIncrementsI;
+    checkEngines(path, quirks);
+    std::remove(path);
+}
+
+// BNNN landing at the top of memory: on the last instruction, on the last
+// byte, and past the end
+TEST(enginesMatchOnJumpsNearTopOfMemory)
+{
+    const int programSize = 4096 - 512;
+    const int top = 4096 - 2 - 512;
+    for (std::uint8_t offset : { 0xEE, 0xEF, 0xFF })
+    {
+        std::vector<std::uint8_t> program(programSize);
+        const std::uint8_t code[] =
+        {
+            0x60, offset,   // 200: V0 = offset
+            0x71, 0x01,     // 202: V1 += 1
+            0xBF, 0x10,     // 204: JP V0, 0xF10
+        };
+        std::copy(code, code + sizeof(code), program.begin());
+        // FFE: V1 += 3, then the program counter wraps into the font
+        program[top] = 0x71;
+        program[top + 1] = 0x03;
+        const char* path = writeProgram("bnnn.ch8", program.data(), program.size());
+        checkEngines(path);
+        Quirks quirks;
+        quirks.jumpAddsVx = true;
+        checkEngines(path, quirks);
+        std::remove(path);
+    }
+}
+
+// Recompiled blocks run while memory holds the ROM they came from; a store
+// into a running block ends it and hands the rest to the interpreter
+TEST(nativeProgramsMatchInterpreter)
+{
+    for (const NativeProgram* program : { &opcodeProgram, &selfModifyingProgram })
+    {
+        const char* path = writeProgram("native.ch8", program->rom, program->romSize);
+        const Quirks quirks = Quirks::fromBits(program->quirks);
+        CHECK(runProgram(path, Dispatch::Switch, quirks, program) == runProgram(path, Dispatch::Switch, quirks));
+        std::remove(path);
+    }
+}
@@ -0,0 +1,146 @@
+// Environment resets and steps must leave every instance, and the screen
+// observed of it, exactly as a machine driven on its own by the same seed
+// and actions.
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include "../src/Chip8.h"
+#include "../src/Environment.h"
+#include "Test.h"
+
+static const int INSTANCES = 9;
+static const int WORKERS = 3;
+static const int STEPS = 40;
+static const int FRAMES_PER_STEP = 4;
+static const int CLOCK_RATE = 700;
+
+static std::uint16_t action(int instance, int step)
+{
+    const int phase = (instance + step / 5) % 3;
+    return static_cast<std::uint16_t>(phase == 0 ? 1 << 4 : phase == 1 ? 1 << 6 : 0);
+}
+
+// Restarts the machines the environment is compared with, as
+// Environment::reset does
+static void resetAlone(std::vector<std::unique_ptr<Chip8>>& alone, const std::vector<std::uint32_t>& seeds)
+{
+    alone.clear();
+    for (std::uint32_t seed : seeds)
+    {
+        alone.emplace_back(new Chip8(BREAKOUT_ROM));
+        alone.back()->setClockRate(CLOCK_RATE);
+        alone.back()->seed(seed);
+    }
+}
+
+static bool observes(const Environment& environment, const std::vector<std::uint8_t>& observations,
+    const std::vector<std::unique_ptr<Chip8>>& alone)
+{
+    const int size = environment.getObservationSize();
+    std::vector<std::uint8_t> expected(size);
+    for (int i = 0; i < INSTANCES; ++i)
+    {
+        alone[i]->getDisplay().copyPixels(expected.data());
+        if (!std::equal(expected.begin(), expected.end(), observations.begin() + i * size))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+static bool matches(Environment& environment, const std::vector<std::unique_ptr<Chip8>>& alone)
+{
+    for (int i = 0; i < INSTANCES; ++i)
+    {
+        if (environment.getInstance(i).getStateHash() != alone[i]->getStateHash())
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+TEST(environmentMatchesMachinesRunAlone)
+{
+    Environment environment(INSTANCES, BREAKOUT_ROM, Environment::Observation::Bytes, Dispatch::Switch, WORKERS);
+    environment.setClockRate(CLOCK_RATE);
+    CHECK(environment.getObservationSize() == Display::WIDTH * Display::HEIGHT);
+    std::vector<std::uint8_t> observations(INSTANCES * environment.getObservationSize());
+    std::vector<std::unique_ptr<Chip8>> alone;
+
+    // A second episode starts over from the program as loaded, with the
+    // clock rate kept
+    for (std::uint32_t episode = 0; episode < 2; ++episode)
+    {
+        std::vector<std::uint32_t> seeds;
+        for (int i = 0; i < INSTANCES; ++i)
+        {
+            seeds.push_back(episode * 977 + i + 1);
+        }
+        environment.reset(seeds.data(), observations.data());
+        resetAlone(alone, seeds);
+        CHECK(matches(environment, alone));
+        CHECK(observes(environment, observations, alone));
+        CHECK(environment.getInstance(0).getClockRate() == CLOCK_RATE);
+
+        std::vector<std::uint16_t> actions(INSTANCES);
+        for (int step = 0; step < STEPS; ++step)
+        {
+            for (int i = 0; i < INSTANCES; ++i)
+            {
+                actions[i] = action(i, step + episode);
+                alone[i]->setKeys(actions[i]);
+                for (int frame = 0; frame < FRAMES_PER_STEP; ++frame)
+                {
+                    alone[i]->runFrame();
+                }
+            }
+            environment.step(actions.data(), FRAMES_PER_STEP, observations.data());
+            if (!matches(environment, alone) || !observes(environment, observations, alone))
+            {
+                std::cerr << "Episode " << episode << ", step " << step << " differs from machines run alone.\n";
+                CHECK(false);
+                return;
+            }
+        }
+    }
+}
+
+// Packed observations hold the same pixels, eight to a byte with the
+// leftmost in the high bit
+TEST(environmentPacksObservations)
+{
+    Environment bytes(INSTANCES, BREAKOUT_ROM, Environment::Observation::Bytes, Dispatch::Switch, WORKERS);
+    Environment packed(INSTANCES, BREAKOUT_ROM, Environment::Observation::Packed, Dispatch::Switch, WORKERS);
+    CHECK(packed.getObservationSize() == Display::PACKED_ROW_SIZE * Display::HEIGHT);
+    std::vector<std::uint8_t> pixels(INSTANCES * bytes.getObservationSize());
+    std::vector<std::uint8_t> rows(INSTANCES * packed.getObservationSize());
+    std::vector<std::uint32_t> seeds(INSTANCES, 3);
+    bytes.reset(seeds.data(), pixels.data());
+    packed.reset(seeds.data(), rows.data());
+
+    std::vector<std::uint16_t> actions(INSTANCES);
+    int lit = 0;
+    bool same = true;
+    for (int step = 0; step < STEPS; ++step)
+    {
+        for (int i = 0; i < INSTANCES; ++i)
+        {
+            actions[i] = action(i, step);
+        }
+        bytes.step(actions.data(), FRAMES_PER_STEP, pixels.data());
+        packed.step(actions.data(), FRAMES_PER_STEP, rows.data());
+        for (std::size_t pixel = 0; pixel < pixels.size(); ++pixel)
+        {
+            const int bit = rows[pixel / 8] >> (7 - pixel % 8) & 1;
+            same &= bit == pixels[pixel];
+            lit += pixels[pixel];
+        }
+    }
+    CHECK(same);
+    CHECK(lit > 0);
+}
@@ -0,0 +1,109 @@
+// Every instance of a Fleet must end up exactly where the same machine run
+// on its own does, whichever worker ran it and however its budget fell.
+
+#include <climits>
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include "../src/Chip8.h"
+#include "../src/Fleet.h"
+#include "Test.h"
+
+static const int INSTANCES = 23;
+// More workers than most hosts running the tests have cores, so ranges
+// get stolen
+static const int WORKERS = 4;
+static const int ROUNDS = 3;
+static const int FRAMES_PER_ROUND = 50;
+
+// Every third instance runs unbudgeted; the rest run out at different
+// points, mostly partway through a frame
+static std::uint64_t instanceBudget(int instance, int clockRate)
+{
+    if (instance % 3 == 0)
+    {
+        return Fleet::UNLIMITED;
+    }
+    const int frameCycles = clockRate == Scheduler::UNLIMITED ? Scheduler::UNLIMITED_FRAME_CYCLES : clockRate / Scheduler::TIMER_RATE;
+    return static_cast<std::uint64_t>(frameCycles) * (instance * 11 % 200) + instance;
+}
+
+// Moves the paddle one way, the other way or not at all
+static std::uint16_t instanceKeys(int instance, int round)
+{
+    const int phase = (instance + round) % 3;
+    return static_cast<std::uint16_t>(phase == 0 ? 1 << 4 : phase == 1 ? 1 << 6 : 0);
+}
+
+// What Fleet::runFrames does for one instance
+static void runAlone(Chip8& chip8, int frames, std::uint64_t budget)
+{
+    for (int frame = 0; frame < frames && chip8.getCycles() < budget; ++frame)
+    {
+        const std::uint64_t left = budget - chip8.getCycles();
+        chip8.runFrame(left < INT_MAX ? static_cast<int>(left) : INT_MAX);
+    }
+}
+
+static void checkFleet(int clockRate)
+{
+    Fleet fleet(INSTANCES, BREAKOUT_ROM, Dispatch::Switch, WORKERS);
+    CHECK(fleet.getWorkerCount() == WORKERS);
+    fleet.setClockRate(clockRate);
+    std::vector<std::unique_ptr<Chip8>> alone;
+    for (int i = 0; i < INSTANCES; ++i)
+    {
+        fleet.getInstance(i).seed(i + 1);
+        fleet.setBudget(i, instanceBudget(i, clockRate));
+        alone.emplace_back(new Chip8(BREAKOUT_ROM));
+        alone.back()->setClockRate(clockRate);
+        alone.back()->seed(i + 1);
+    }
+
+    std::uint64_t instructions = 0;
+    for (int round = 0; round < ROUNDS; ++round)
+    {
+        for (int i = 0; i < INSTANCES; ++i)
+        {
+            fleet.getInstance(i).setKeys(instanceKeys(i, round));
+            alone[i]->setKeys(instanceKeys(i, round));
+        }
+        fleet.runFrames(FRAMES_PER_ROUND);
+        for (int i = 0; i < INSTANCES; ++i)
+        {
+            const std::uint64_t before = alone[i]->getCycles();
+            runAlone(*alone[i], FRAMES_PER_ROUND, instanceBudget(i, clockRate));
+            instructions += alone[i]->getCycles() - before;
+        }
+    }
+
+    int budgeted = 0;
+    int spent = 0;
+    for (int i = 0; i < INSTANCES; ++i)
+    {
+        const Chip8& chip8 = fleet.getInstance(i);
+        if (chip8.getStateHash() != alone[i]->getStateHash() || chip8.getCycles() != alone[i]->getCycles())
+        {
+            std::cerr << "Clock " << clockRate << ": instance " << i << " differs from a machine run alone.\n";
+            CHECK(false);
+        }
+        CHECK(chip8.getCycles() <= instanceBudget(i, clockRate));
+        budgeted += instanceBudget(i, clockRate) != Fleet::UNLIMITED;
+        spent += chip8.getCycles() == instanceBudget(i, clockRate);
+    }
+    // Some budgets ran out, and some did not
+    CHECK(spent > 0 && spent < budgeted);
+    CHECK(fleet.getTotalInstructions() == instructions);
+}
+
+TEST(fleetInstancesMatchMachinesRunAlone)
+{
+    checkFleet(700);
+}
+
+// Unlimited frames are a fixed instruction count, so they too are the same
+// on every worker
+TEST(fleetInstancesMatchMachinesRunAloneAtUnlimitedClock)
+{
+    checkFleet(Scheduler::UNLIMITED);
+}
@@ -0,0 +1,122 @@
+// A movie saved, loaded and played back, from the start or after a seek,
+// must reproduce the recorded run frame for frame.
+
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <vector>
+#include "../src/Chip8.h"
+#include "../src/Movie.h"
+#include "Test.h"
+
+static const int FRAMES = 1500;
+static const int SNAPSHOT_INTERVAL = 100;
+static const char* const MOVIE_PATH = "test.c8m";
+
+// Records Breakout while the paddle moves. Returns the state hash before
+// every frame, and after the last.
+static std::vector<std::uint64_t> recordMovie(Movie& movie, int clockRate)
+{
+    Chip8 chip8(BREAKOUT_ROM);
+    chip8.setClockRate(clockRate);
+    movie.begin(chip8, 7);
+    chip8.setMovie(&movie);
+    std::vector<std::uint64_t> hashes;
+    for (int frame = 0; frame < FRAMES; ++frame)
+    {
+        hashes.push_back(chip8.getStateHash());
+        if (frame % 45 == 0)
+        {
+            const int phase = frame / 45 % 3;
+            chip8.setKeys(static_cast<std::uint16_t>(phase == 0 ? 1 << 4 : phase == 1 ? 1 << 6 : 0));
+        }
+        chip8.runFrame();
+        movie.endFrame(chip8);
+    }
+    hashes.push_back(chip8.getStateHash());
+    chip8.setMovie(nullptr);
+    return hashes;
+}
+
+// Saves the movie and plays the copy loaded back into a fresh machine
+static void checkPlayback(int clockRate)
+{
+    Movie recorded(SNAPSHOT_INTERVAL);
+    const std::vector<std::uint64_t> hashes = recordMovie(recorded, clockRate);
+    CHECK(recorded.save(MOVIE_PATH));
+
+    Movie movie;
+    CHECK(movie.load(MOVIE_PATH));
+    CHECK(movie.getFrameCount() == FRAMES);
+    CHECK(movie.getSeed() == 7);
+
+    Chip8 chip8(BREAKOUT_ROM);
+    CHECK(movie.seek(chip8, 0));
+    CHECK(chip8.getClockRate() == clockRate);
+    for (int frame = 0; frame < FRAMES; ++frame)
+    {
+        CHECK(chip8.getStateHash() == hashes[frame]);
+        CHECK(movie.playFrame(chip8));
+    }
+    CHECK(chip8.getStateHash() == hashes[FRAMES]);
+    CHECK(!movie.playFrame(chip8));
+    std::remove(MOVIE_PATH);
+}
+
+TEST(moviePlaysBackRecordedRun)
+{
+    // 700 Hz does not divide into frames, so replay depends on the timer phase
+    checkPlayback(700);
+}
+
+TEST(moviePlaysBackUnlimitedClockRun)
+{
+    checkPlayback(0);
+}
+
+TEST(movieSeeksToAnyFrame)
+{
+    Movie movie(SNAPSHOT_INTERVAL);
+    const std::vector<std::uint64_t> hashes = recordMovie(movie, 700);
+    Chip8 chip8(BREAKOUT_ROM);
+    // Forwards and backwards, onto, either side of and between snapshots
+    for (int frame : { FRAMES, 0, 1234, 99, 100, 101, 750, 1, FRAMES - 1, 0 })
+    {
+        CHECK(movie.seek(chip8, frame));
+        CHECK(movie.getFrame() == static_cast<std::uint64_t>(frame));
+        CHECK(chip8.getStateHash() == hashes[frame]);
+    }
+    // Playback carries on from the frame sought to
+    CHECK(movie.seek(chip8, 640));
+    for (int frame = 640; frame < 700; ++frame)
+    {
+        CHECK(movie.playFrame(chip8));
+    }
+    CHECK(chip8.getStateHash() == hashes[700]);
+    CHECK(!movie.seek(chip8, FRAMES + 1));
+}
+
+TEST(movieRejectsTruncatedFile)
+{
+    Movie recorded(SNAPSHOT_INTERVAL);
+    recordMovie(recorded, 700);
+    CHECK(recorded.save(MOVIE_PATH));
+    std::vector<char> bytes;
+    {
+        std::ifstream file(MOVIE_PATH, std::ios::binary);
+        bytes.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    }
+    CHECK(bytes.size() > 16);
+
+    for (std::size_t size : { std::size_t(0), std::size_t(10), bytes.size() / 2, bytes.size() - 1 })
+    {
+        {
+            std::ofstream file(MOVIE_PATH, std::ios::binary | std::ios::trunc);
+            file.write(bytes.data(), size);
+        }
+        Movie movie;
+        CHECK(!movie.load(MOVIE_PATH));
+    }
+    std::remove(MOVIE_PATH);
+}
@@ -0,0 +1,1929 @@
+// Generated by the CHIP-8 recompiler from test_opcode.ch8. Do not edit.
+
+#include "NativeProgram.h"
+
+namespace
+{
+
+const std::uint8_t ROM[] =
+{
+    0x12, 0x4E, 0xEA, 0xAC, 0xAA, 0xEA, 0xCE, 0xAA, 0xAA, 0xAE, 0xE0, 0xA0,
+    0xA0, 0xE0, 0xC0, 0x40, 0x40, 0xE0, 0xE0, 0x20, 0xC0, 0xE0, 0xE0, 0x60,
+    0x20, 0xE0, 0xA0, 0xE0, 0x20, 0x20, 0x60, 0x40, 0x20, 0x40, 0xE0, 0x80,
+    0xE0, 0xE0, 0xE0, 0x20, 0x20, 0x20, 0xE0, 0xE0, 0xA0, 0xE0, 0xE0, 0xE0,
+    0x20, 0xE0, 0x40, 0xA0, 0xE0, 0xA0, 0xE0, 0xC0, 0x80, 0xE0, 0xE0, 0x80,
+    0xC0, 0x80, 0xA0, 0x40, 0xA0, 0xA0, 0xA2, 0x02, 0xDA, 0xB4, 0x00, 0xEE,
+    0xA2, 0x02, 0xDA, 0xB4, 0x13, 0xDC, 0x68, 0x01, 0x69, 0x05, 0x6A, 0x0A,
+    0x6B, 0x01, 0x65, 0x2A, 0x66, 0x2B, 0xA2, 0x16, 0xD8, 0xB4, 0xA2, 0x3E,
+    0xD9, 0xB4, 0xA2, 0x02, 0x36, 0x2B, 0xA2, 0x06, 0xDA, 0xB4, 0x6B, 0x06,
+    0xA2, 0x1A, 0xD8, 0xB4, 0xA2, 0x3E, 0xD9, 0xB4, 0xA2, 0x06, 0x45, 0x2A,
+    0xA2, 0x02, 0xDA, 0xB4, 0x6B, 0x0B, 0xA2, 0x1E, 0xD8, 0xB4, 0xA2, 0x3E,
+    0xD9, 0xB4, 0xA2, 0x06, 0x55, 0x60, 0xA2, 0x02, 0xDA, 0xB4, 0x6B, 0x10,
+    0xA2, 0x26, 0xD8, 0xB4, 0xA2, 0x3E, 0xD9, 0xB4, 0xA2, 0x06, 0x76, 0xFF,
+    0x46, 0x2A, 0xA2, 0x02, 0xDA, 0xB4, 0x6B, 0x15, 0xA2, 0x2E, 0xD8, 0xB4,
+    0xA2, 0x3E, 0xD9, 0xB4, 0xA2, 0x06, 0x95, 0x60, 0xA2, 0x02, 0xDA, 0xB4,
+    0x6B, 0x1A, 0xA2, 0x32, 0xD8, 0xB4, 0xA2, 0x3E, 0xD9, 0xB4, 0x22, 0x42,
+    0x68, 0x17, 0x69, 0x1B, 0x6A, 0x20, 0x6B, 0x01, 0xA2, 0x0A, 0xD8, 0xB4,
+    0xA2, 0x36, 0xD9, 0xB4, 0xA2, 0x02, 0xDA, 0xB4, 0x6B, 0x06, 0xA2, 0x2A,
+    0xD8, 0xB4, 0xA2, 0x0A, 0xD9, 0xB4, 0xA2, 0x06, 0x87, 0x50, 0x47, 0x2A,
+    0xA2, 0x02, 0xDA, 0xB4, 0x6B, 0x0B, 0xA2, 0x2A, 0xD8, 0xB4, 0xA2, 0x0E,
+    0xD9, 0xB4, 0xA2, 0x06, 0x67, 0x2A, 0x87, 0xB1, 0x47, 0x2B, 0xA2, 0x02,
+    0xDA, 0xB4, 0x6B, 0x10, 0xA2, 0x2A, 0xD8, 0xB4, 0xA2, 0x12, 0xD9, 0xB4,
+    0xA2, 0x06, 0x66, 0x78, 0x67, 0x1F, 0x87, 0x62, 0x47, 0x18, 0xA2, 0x02,
+    0xDA, 0xB4, 0x6B, 0x15, 0xA2, 0x2A, 0xD8, 0xB4, 0xA2, 0x16, 0xD9, 0xB4,
+    0xA2, 0x06, 0x66, 0x78, 0x67, 0x1F, 0x87, 0x63, 0x47, 0x67, 0xA2, 0x02,
+    0xDA, 0xB4, 0x6B, 0x1A, 0xA2, 0x2A, 0xD8, 0xB4, 0xA2, 0x1A, 0xD9, 0xB4,
+    0xA2, 0x06, 0x66, 0x8C, 0x67, 0x8C, 0x87, 0x64, 0x47, 0x18, 0xA2, 0x02,
+    0xDA, 0xB4, 0x68, 0x2C, 0x69, 0x30, 0x6A, 0x34, 0x6B, 0x01, 0xA2, 0x2A,
+    0xD8, 0xB4, 0xA2, 0x1E, 0xD9, 0xB4, 0xA2, 0x06, 0x66, 0x8C, 0x67, 0x78,
+    0x87, 0x65, 0x47, 0xEC, 0xA2, 0x02, 0xDA, 0xB4, 0x6B, 0x06, 0xA2, 0x2A,
+    0xD8, 0xB4, 0xA2, 0x22, 0xD9, 0xB4, 0xA2, 0x06, 0x66, 0xE0, 0x86, 0x6E,
+    0x46, 0xC0, 0xA2, 0x02, 0xDA, 0xB4, 0x6B, 0x0B, 0xA2, 0x2A, 0xD8, 0xB4,
+    0xA2, 0x36, 0xD9, 0xB4, 0xA2, 0x06, 0x66, 0x0F, 0x86, 0x66, 0x46, 0x07,
+    0xA2, 0x02, 0xDA, 0xB4, 0x6B, 0x10, 0xA2, 0x3A, 0xD8, 0xB4, 0xA2, 0x1E,
+    0xD9, 0xB4, 0xA3, 0xE8, 0x60, 0x00, 0x61, 0x30, 0xF1, 0x55, 0xA3, 0xE9,
+    0xF0, 0x65, 0xA2, 0x06, 0x40, 0x30, 0xA2, 0x02, 0xDA, 0xB4, 0x6B, 0x15,
+    0xA2, 0x3A, 0xD8, 0xB4, 0xA2, 0x16, 0xD9, 0xB4, 0xA3, 0xE8, 0x66, 0x89,
+    0xF6, 0x33, 0xF2, 0x65, 0xA2, 0x02, 0x30, 0x01, 0xA2, 0x06, 0x31, 0x03,
+    0xA2, 0x06, 0x32, 0x07, 0xA2, 0x06, 0xDA, 0xB4, 0x6B, 0x1A, 0xA2, 0x0E,
+    0xD8, 0xB4, 0xA2, 0x3E, 0xD9, 0xB4, 0x12, 0x48, 0x13, 0xDC,
+};
+
+int block_200(NativeContext& context)
+{
+    std::uint16_t& pc = context.pc;
+
+    // 0x200: 0x124E
+    pc = 0x24E;
+    return 1;
+}
+
+int block_242(NativeContext& context)
+{
+    std::uint16_t& I = context.I;
+    std::uint16_t& pc = context.pc;
+
+    // 0x242: 0xA202
+    I = 0x202;
+
+    // 0x244: 0xDAB4
+    pc = 0x244;
+    if (context.interpret(0xB40B0A18))
+    {
+        return 2;
+    }
+
+    // 0x246: 0x00EE
+    pc = 0x246;
+    context.interpret(0xEE0E0003);
+    return 3;
+}
+
+int block_248(NativeContext& context)
+{
+    std::uint16_t& I = context.I;
+    std::uint16_t& pc = context.pc;
+
+    // 0x248: 0xA202
+    I = 0x202;
+
+    // 0x24A: 0xDAB4
+    pc = 0x24A;
+    if (context.interpret(0xB40B0A18))
+    {
+        return 2;
+    }
+
+    // 0x24C: 0x13DC
+    pc = 0x3DC;
+    return 3;
+}
+
+int block_24E(NativeContext& context)
+{
+    std::uint8_t* V = context.V;
+    std::uint16_t& I = context.I;
+    std::uint16_t& pc = context.pc;
+
+    // 0x24E: 0x6801
+    V[0x8] = 0x01;
+
+    // 0x250: 0x6905
+    V[0x9] = 0x05;
+
+    // 0x252: 0x6A0A
+    V[0xA] = 0x0A;
+
+    // 0x254: 0x6B01
+    V[0xB] = 0x01;
+
+    // 0x256: 0x652A
+    V[0x5] = 0x2A;
+
+    // 0x258: 0x662B
+    V[0x6] = 0x2B;
+
+    // 0x25A: 0xA216
+    I = 0x216;
+
+    // 0x25C: 0xD8B4
+    pc = 0x25C;
+    if (context.interpret(0xB40B0818))
+    {
+        return 8;
+    }
+
+    // 0x25E: 0xA23E
+    I = 0x23E;
+
+    // 0x260: 0xD9B4
+    pc = 0x260;
+    if (context.interpret(0xB40B0918))
+    {
+        return 10;
+    }
+
+    // 0x262: 0xA202
+    I = 0x202;
+
+    // 0x264: 0x362B
+    pc = V[0x6] == 0x2B ? 0x268 : 0x266;
+    return 12;
+}
+
+int block_266(NativeContext& context)
+{
+    std::uint8_t* V = context.V;
+    std::uint16_t& I = context.I;
+    std::uint16_t& pc = context.pc;
+
+    // 0x266: 0xA206
+    I = 0x206;
+
+    // 0x268: 0xDAB4
+    pc = 0x268;
+    if (context.interpret(0xB40B0A18))
+    {
+        return 2;
+    }
+
+    // 0x26A: 0x6B06
+    V[0xB] = 0x06;
+
+    // 0x26C: 0xA21A
+    I = 0x21A;
+
+    // 0x26E: 0xD8B4
+    pc = 0x26E;
+    if (context.interpret(0xB40B0818))
+    {
+        return 5;
+    }
+
+    // 0x270: 0xA23E
+    I = 0x23E;
+
+    // 0x272: 0xD9B4
+    pc = 0x272;
+    if (context.interpret(0xB40B0918))
+    {
+        return 7;
+    }
+
+    // 0x274: 0xA206
+    I = 0x206;
+
+    // 0x276: 0x452A
+    pc = V[0x5] != 0x2A ? 0x27A : 0x278;
+    return 9;
+}
+
+int block_268(NativeContext& context)
+{
+    std::uint8_t* V = context.V;
+    std::uint16_t& I = context.I;
+    std::uint16_t& pc = context.pc;
+
+    // 0x268: 0xDAB4
+    pc = 0x268;
+    if (context.interpret(0xB40B0A18))
+    {
+        return 1;
+    }
+
+    // 0x26A: 0x6B06
+    V[0xB] = 0x06;
+
+    // 0x26C: 0xA21A
+    I = 0x21A;
+
+    // 0x26E: 0xD8B4
+    pc = 0x26E;
+    if (context.interpret(0xB40B0818))
+    {
+        return 4;
+    }
+
+    // 0x270: 0xA23E
+    I = 0x23E;
+
+    // 0x272: 0xD9B4
+    pc = 0x272;
+    if (context.interpret(0xB40B0918))
+    {
+        return 6;
+    }
+
+    // 0x274: 0xA206
+    I = 0x206;
+
+    // 0x276: 0x452A
+    pc = V[0x5] != 0x2A ? 0x27A : 0x278;
+    return 8;
+}
+
+int block_278(NativeContext& context)
+{
+    std::uint8_t* V = context.V;
+    std::uint16_t& I = context.I;
+    std::uint16_t& pc = context.pc;
+
+    // 0x278: 0xA202
+    I = 0x202;
+
+    // 0x27A: 0xDAB4
+    pc = 0x27A;
+    if (context.interpret(0xB40B0A18))
+    {
+        return 2;
+    }
+
+    // 0x27C: 0x6B0B
+    V[0xB] = 0x0B;
+
+    // 0x27E: 0xA21E
+    I = 0x21E;
+
+    // 0x280: 0xD8B4
+    pc = 0x280;
+    if (context.interpret(0xB40B0818))
+    {
+        return 5;
+    }
+
+    // 0x282: 0xA23E
+    I = 0x23E;
+
+    // 0x284: 0xD9B4
+    pc = 0x284;
+    if (context.interpret(0xB40B0918))
+    {
+        return 7;
+    }
+
+    // 0x286: 0xA206
+    I = 0x206;
+
+    // 0x288: 0x5560
+    pc = V[0x5] == V[0x6] ? 0x28C : 0x28A;
+    return 9;
+}
+
+int block_27A(NativeContext& context)
+{
+    std::uint8_t* V = context.V;
+    std::uint16_t& I = context.I;
+    std::uint16_t& pc = context.pc;
+
+    // 0x27A: 0xDAB4
+    pc = 0x27A;
+    if (context.interpret(0xB40B0A18))
+    {
+        return 1;
+    }
+
+    // 0x27C: 0x6B0B
+    V[0xB] = 0x0B;
+
+    // 0x27E: 0xA21E
+    I = 0x21E;
+
+    // 0x280: 0xD8B4
+    pc = 0x280;
+    if (context.interpret(0xB40B0818))
+    {
+        return 4;
+    }
+
+    // 0x282: 0xA23E
+    I = 0x23E;
+
+    // 0x284: 0xD9B4
+    pc = 0x284;
+    if (context.interpret(0xB40B0918))
+    {
+        return 6;
+    }
+
+    // 0x286: 0xA206
+    I = 0x206;
+
+    // 0x288: 0x5560
+    pc = V[0x5] == V[0x6] ? 0x28C : 0x28A;
+    return 8;
+}
+
+int block_28A(NativeContext& context)
+{
+    std::uint8_t* V = context.V;
+    std::uint16_t& I = context.I;
+    std::uint16_t& pc = context.pc;
+
+    // 0x28A: 0xA202
+    I = 0x202;
+
+    // 0x28C: 0xDAB4
+    pc = 0x28C;
+    if (context.interpret(0xB40B0A18))
+    {
+        return 2;
+    }
+
+    // 0x28E: 0x6B10
+    V[0xB] = 0x10;
+
+    // 0x290: 0xA226
+    I = 0x226;
+
+    // 0x292: 0xD8B4
+    pc = 0x292;
+    if (context.interpret(0xB40B0818))
+    {
+        return 5;
+    }
+
+    // 0x294: 0xA23E
+    I = 0x23E;
+
+    // 0x296: 0xD9B4
+    pc = 0x296;
+    if (context.interpret(0xB40B0918))
+    {
+        return 7;
+    }
+
+    // 0x298: 0xA206
+    I = 0x206;
+
+    // 0x29A: 0x76FF
+    V[0x6] += 0xFF;
+
+    // 0x29C: 0x462A
+    pc = V[0x6] != 0x2A ? 0x2A0 : 0x29E;
+    return 10;
+}
+
+int block_28C(NativeContext& context)
+{
+    std::uint8_t* V = context.V;
+    std::uint16_t& I = context.I;
+    std::uint16_t& pc = context.pc;
+
+    // 0x28C: 0xDAB4
+    pc = 0x28C;
+    if (context.interpret(0xB40B0A18))
+    {
+        return 1;
+    }
+
+    // 0x28E: 0x6B10
+    V[0xB] = 0x10;
+
+    // 0x290: 0xA226
+    I = 0x226;
+
+    // 0x292: 0xD8B4
+    pc = 0x292;
+    if (context.interpret(0xB40B0818))
+    {
+        return 4;
+    }
+
+    // 0x294: 0xA23E
+    I = 0x23E;
+
+    // 0x296: 0xD9B4
+    pc = 0x296;
+    if (context.interpret(0xB40B0918))
+    {
+        return 6;
+    }
+
+    // 0x298: 0xA206
+    I = 0x206;
+
+    // 0x29A: 0x76FF
+    V[0x6] += 0xFF;
+
+    // 0x29C: 0x462A
+    pc = V[0x6] != 0x2A ? 0x2A0 : 0x29E;
+    return 9;
+}
+
+int block_29E(NativeContext& context)
+{
+    std::uint8_t* V = context.V;
+    std::uint16_t& I = context.I;
+    std::uint16_t& pc = context.pc;
+
+    // 0x29E: 0xA202
+    I = 0x202;
+
+    // 0x2A0: 0xDAB4
+    pc = 0x2A0;
+    if (context.interpret(0xB40B0A18))
+    {
+        return 2;
+    }
+
+    // 0x2A2: 0x6B15
+    V[0xB] = 0x15;
+
+    // 0x2A4: 0xA22E
+    I = 0x22E;
+
+    // 0x2A6: 0xD8B4
+    pc = 0x2A6;
+    if (context.interpret(0xB40B0818))
+    {
+        return 5;
+    }
+
+    // 0x2A8: 0xA23E
+    I = 0x23E;
+
+    // 0x2AA: 0xD9B4
+    pc = 0x2AA;
+    if (context.interpret(0xB40B0918))
+    {
+        return 7;
+    }
+
+    // 0x2AC: 0xA206
+    I = 0x206;
+
+    // 0x2AE: 0x9560
+    pc = V[0x5] != V[0x6] ? 0x2B2 : 0x2B0;
+    return 9;
+}
+
+int block_2A0(NativeContext& context)
+{
+    std::uint8_t* V = context.V;
+    std::uint16_t& I = context.I;
+    std::uint16_t& pc = context.pc;
+
+    // 0x2A0: 0xDAB4
+    pc = 0x2A0;
+    if (context.interpret(0xB40B0A18))
+    {
+        return 1;
+    }
+
+    // 0x2A2: 0x6B15
+    V[0xB] = 0x15;
+
+    // 0x2A4: 0xA22E
+    I = 0x22E;
+
+    // 0x2A6: 0xD8B4
+    pc = 0x2A6;
+    if (context.interpret(0xB40B0818))
+    {
+        return 4;
+    }
+
+    // 0x2A8: 0xA23E
+    I = 0x23E;
+
+    // 0x2AA: 0xD9B4
+    pc = 0x2AA;
+    if (context.interpret(0xB40B0918))
+    {
+        return 6;
+    }
+
+    // 0x2AC: 0xA206
+    I = 0x206;
+
+    // 0x2AE: 0x9560
+    pc = V[0x5] != V[0x6] ? 0x2B2 : 0x2B0;
+    return 8;
+}
+
+int block_2B0(NativeContext& context)
+{
+    std::uint8_t* V = context.V;
+    std::uint16_t& I = context.I;
+    std::uint16_t& pc = context.pc;
+
+    // 0x2B0: 0xA202
+    I = 0x202;
+
+    // 0x2B2: 0xDAB4
+    pc = 0x2B2;
+    if (context.interpret(0xB40B0A18))
+    {
+        return 2;
+    }
+
+    // 0x2B4: 0x6B1A
+    V[0xB] = 0x1A;
+
+    // 0x2B6: 0xA232
+    I = 0x232;
+
+    // 0x2B8: 0xD8B4
+    pc = 0x2B8;
+    if (context.interpret(0xB40B0818))
+    {
+        return 5;
+    }
+
+    // 0x2BA: 0xA23E
+    I = 0x23E;
+
+    // 0x2BC: 0xD9B4
+    pc = 0x2BC;
+    if (context.interpret(0xB40B0918))
+    {
+        return 7;
+    }
+
+    // 0x2BE: 0x2242
+    pc = 0x2BE;
+    context.interpret(0x42040205);
+    return 8;
+}
+
+int block_2B2(NativeContext& context)
+{
+    std::uint8_t* V = context.V;
+    std::uint16_t& I = context.I;
+    std::uint16_t& pc = context.pc;
+
+    // 0x2B2: 0xDAB4
+    pc = 0x2B2;
+    if (context.interpret(0xB40B0A18))
+    {
+        return 1;
+    }
+
+    // 0x2B4: 0x6B1A
+    V[0xB] = 0x1A;
+
+    // 0x2B6: 0xA232
+    I = 0x232;
+
+    // 0x2B8: 0xD8B4
+    pc = 0x2B8;
+    if (context.interpret(0xB40B0818))
+    {
+        return 4;
+    }
+
+    // 0x2BA: 0xA23E
+    I = 0x23E;
+
+    // 0x2BC: 0xD9B4
+    pc = 0x2BC;
+    if (context.interpret(0xB40B0918))
+    {
+        return 6;
+    }
+
+    // 0x2BE: 0x2242
+    pc = 0x2BE;
+    context.interpret(0x42040205);
+    return 7;
+}
+
+int block_2C0(NativeContext& context)
+{
+    std::uint8_t* V = context.V;
+    std::uint16_t& I = context.I;
+    std::uint16_t& pc = context.pc;
+
+    // 0x2C0: 0x6817
+    V[0x8] = 0x17;
+
+    // 0x2C2: 0x691B
+    V[0x9] = 0x1B;
+
+    // 0x2C4: 0x6A20
+    V[0xA] = 0x20;
+
+    // 0x2C6: 0x6B01
+    V[0xB] = 0x01;
+
+    // 0x2C8: 0xA20A
+    I = 0x20A;
+
+    // 0x2CA: 0xD8B4
+    pc = 0x2CA;
+    if (context.interpret(0xB40B0818))
+    {
+        return 6;
+    }
+
+    // 0x2CC: 0xA236
+    I = 0x236;
+
+    // 0x2CE: 0xD9B4
+    pc = 0x2CE;
+    if (context.interpret(0xB40B0918))
+    {
+        return 8;
+    }
+
+    // 0x2D0: 0xA202
+    I = 0x202;
+
+    // 0x2D2: 0xDAB4
+    pc = 0x2D2;
+    if (context.interpret(0xB40B0A18))
+    {
+        return 10;
+    }
+
+    // 0x2D4: 0x6B06
+    V[0xB] = 0x06;
+
+    // 0x2D6: 0xA22A
+    I = 0x22A;
+
+    // 0x2D8: 0xD8B4
+    pc = 0x2D8;
+    if (context.interpret(0xB40B0818))
+    {
+        return 13;
+    }
+
+    // 0x2DA: 0xA20A
+    I = 0x20A;
+
+    // 0x2DC: 0xD9B4
+    pc = 0x2DC;
+    if (context.interpret(0xB40B0918))
+    {
+        return 15;
+    }
+
+    // 0x2DE: 0xA206
+    I = 0x206;
+
+    // 0x2E0: 0x8750
+    V[0x7] = V[0x5];
+
+    // 0x2E2: 0x472A
+    pc = V[0x7] != 0x2A ? 0x2E6 : 0x2E4;
+    return 18;
+}
+
+int block_2E4(NativeContext& context)
+{
+    std::uint8_t* V = context.V;
+    std::uint16_t& I = context.I;
+    std::uint16_t& pc = context.pc;
+
+    // 0x2E4: 0xA202
+    I = 0x202;
+
+    // 0x2E6: 0xDAB4
+    pc = 0x2E6;
+    if (context.interpret(0xB40B0A18))
+    {
+        return 2;
+    }
+
+    // 0x2E8: 0x6B0B
+    V[0xB] = 0x0B;
+
+    // 0x2EA: 0xA22A
+    I = 0x22A;
+
+    // 0x2EC: 0xD8B4
+    pc = 0x2EC;
+    if (context.interpret(0xB40B0818))
+    {
+        return 5;
+    }
+
+    // 0x2EE: 0xA20E
+    I = 0x20E;
+
+    // 0x2F0: 0xD9B4
+    pc = 0x2F0;
+    if (context.interpret(0xB40B0918))
+    {
+        return 7;
+    }
+
+    // 0x2F2: 0xA206
+    I = 0x206;
+
+    // 0x2F4: 0x672A
+    V[0x7] = 0x2A;
+
+    // 0x2F6: 0x87B1
+    V[0x7] |= V[0xB];
+
+    // 0x2F8: 0x472B
+    pc = V[0x7] != 0x2B ? 0x2FC : 0x2FA;
+    return 11;
+}
+
+int block_2E6(NativeContext& context)
+{
+    std::uint8_t* V = context.V;
+    std::uint16_t& I = context.I;
+    std::uint16_t& pc = context.pc;
+
+    // 0x2E6: 0xDAB4
+    pc = 0x2E6;
+    if (context.interpret(0xB40B0A18))
+    {
+        return 1;
+    }
+
+    // 0x2E8: 0x6B0B
+    V[0xB] = 0x0B;
+
+    // 0x2EA: 0xA22A
+    I = 0x22A;
+
+    // 0x2EC: 0xD8B4
+    pc = 0x2EC;
+    if (context.interpret(0xB40B0818))
+    {
+        return 4;
+    }
+
+    // 0x2EE: 0xA20E
+    I = 0x20E;
+
+    // 0x2F0: 0xD9B4
+    pc = 0x2F0;
+    if (context.interpret(0xB40B0918))
+    {
+        return 6;
+    }
+
+    // 0x2F2: 0xA206
+    I = 0x206;
+
+    // 0x2F4: 0x672A
+    V[0x7] = 0x2A;
+
+    // 0x2F6: 0x87B1
+    V[0x7] |= V[0xB];
+
+    // 0x2F8: 0x472B
+    pc = V[0x7] != 0x2B ? 0x2FC : 0x2FA;
+    return 10;
+}
+
+int block_2FA(NativeContext& context)
+{
+    std::uint8_t* V = context.V;
+    std::uint16_t& I = context.I;
+    std::uint16_t& pc = context.pc;
+
+    // 0x2FA: 0xA202
+    I = 0x202;
+
+    // 0x2FC: 0xDAB4
+    pc = 0x2FC;
+    if (context.interpret(0xB40B0A18))
+    {
+        return 2;
+    }
+
+    // 0x2FE: 0x6B10
+    V[0xB] = 0x10;
+
+    // 0x300: 0xA22A
+    I = 0x22A;
+
+    // 0x302: 0xD8B4
+    pc = 0x302;
+    if (context.interpret(0xB40B0818))
+    {
+        return 5;
+    }
+
+    // 0x304: 0xA212
+    I = 0x212;
+
+    // 0x306: 0xD9B4
+    pc = 0x306;
+    if (context.interpret(0xB40B0918))
+    {
+        return 7;
+    }
+
+    // 0x308: 0xA206
+    I = 0x206;
+
+    // 0x30A: 0x6678
+    V[0x6] = 0x78;
+
+    // 0x30C: 0x671F
+    V[0x7] = 0x1F;
+
+    // 0x30E: 0x8762
+    V[0x7] &= V[0x6];
+
+    // 0x310: 0x4718
+    pc = V[0x7] != 0x18 ? 0x314 : 0x312;
+    return 12;
+}
+
+int block_2FC(NativeContext& context)
+{
+    std::uint8_t* V = context.V;
+    std::uint16_t& I = context.I;
+    std::uint16_t& pc = context.pc;
+
+    // 0x2FC: 0xDAB4
+    pc = 0x2FC;
+    if (context.interpret(0xB40B0A18))
+    {
+        return 1;
+    }
+
+    // 0x2FE: 0x6B10
+    V[0xB] = 0x10;
+
+    // 0x300: 0xA22A
+    I = 0x22A;
+
+    // 0x302: 0xD8B4
+    pc = 0x302;
+    if (context.interpret(0xB40B0818))
+    {
+        return 4;
+    }
+
+    // 0x304: 0xA212
+    I = 0x212;
+
+    // 0x306: 0xD9B4
+    pc = 0x306;
+    if (context.interpret(0xB40B0918))
+    {
+        return 6;
+    }
+
+    // 0x308: 0xA206
+    I = 0x206;
+
+    // 0x30A: 0x6678
+    V[0x6] = 0x78;
+
+    // 0x30C: 0x671F
+    V[0x7] = 0x1F;
+
+    // 0x30E: 0x8762
+    V[0x7] &= V[0x6];
+
+    // 0x310: 0x4718
+    pc = V[0x7] != 0x18 ? 0x314 : 0x312;
+    return 11;
+}
+
+int block_312(NativeContext& context)
+{
+    std::uint8_t* V = context.V;
+    std::uint16_t& I = context.I;
+    std::uint16_t& pc = context.pc;
+
+    // 0x312: 0xA202
+    I = 0x202;
+
+    // 0x314: 0xDAB4
+    pc = 0x314;
+    if (context.interpret(0xB40B0A18))
+    {
+        return 2;
+    }
+
+    // 0x316: 0x6B15
+    V[0xB] = 0x15;
+
+    // 0x318: 0xA22A
+    I = 0x22A;
+
+    // 0x31A: 0xD8B4
+    pc = 0x31A;
+    if (context.interpret(0xB40B0818))
+    {
+        return 5;
+    }
+
+    // 0x31C: 0xA216
+    I = 0x216;
+
+    // 0x31E: 0xD9B4
+    pc = 0x31E;
+    if (context.interpret(0xB40B0918))
+    {
+        return 7;
+    }
+
+    // 0x320: 0xA206
+    I = 0x206;
+
+    // 0x322: 0x6678
+    V[0x6] = 0x78;
+
+    // 0x324: 0x671F
+    V[0x7] = 0x1F;
+
+    // 0x326: 0x8763
+    V[0x7] ^= V[0x6];
+
+    // 0x328: 0x4767
+    pc = V[0x7] != 0x67 ? 0x32C : 0x32A;
+    return 12;
+}
+
+int block_314(NativeContext& context)
+{
+    std::uint8_t* V = context.V;
+    std::uint16_t& I = context.I;
+    std::uint16_t& pc = context.pc;
+
+    // 0x314: 0xDAB4
+    pc = 0x314;
+    if (context.interpret(0xB40B0A18))
+    {
+        return 1;
+    }
+
+    // 0x316: 0x6B15
+    V[0xB] = 0x15;
+
+    // 0x318: 0xA22A
+    I = 0x22A;
+
+    // 0x31A: 0xD8B4
+    pc = 0x31A;
+    if (context.interpret(0xB40B0818))
+    {
+        return 4;
+    }
+
+    // 0x31C: 0xA216
+    I = 0x216;
+
+    // 0x31E: 0xD9B4
+    pc = 0x31E;
+    if (context.interpret(0xB40B0918))
+    {
+        return 6;
+    }
+
+    // 0x320: 0xA206
+    I = 0x206;
+
+    // 0x322: 0x6678
+    V[0x6] = 0x78;
+
+    // 0x324: 0x671F
+    V[0x7] = 0x1F;
+
+    // 0x326: 0x8763
+    V[0x7] ^= V[0x6];
+
+    // 0x328: 0x4767
+    pc = V[0x7] != 0x67 ? 0x32C : 0x32A;
+    return 11;
+}
+
+int block_32A(NativeContext& context)
+{
+    std::uint8_t* V = context.V;
+    std::uint16_t& I = context.I;
+    std::uint16_t& pc = context.pc;
+
+    // 0x32A: 0xA202
+    I = 0x202;
+
+    // 0x32C: 0xDAB4
+    pc = 0x32C;
+    if (context.interpret(0xB40B0A18))
+    {
+        return 2;
+    }
+
+    // 0x32E: 0x6B1A
+    V[0xB] = 0x1A;
+
+    // 0x330: 0xA22A
+    I = 0x22A;
+
+    // 0x332: 0xD8B4
+    pc = 0x332;
+    if (context.interpret(0xB40B0818))
+    {
+        return 5;
+    }
+
+    // 0x334: 0xA21A
+    I = 0x21A;
+
+    // 0x336: 0xD9B4
+    pc = 0x336;
+    if (context.interpret(0xB40B0918))
+    {
+        return 7;
+    }
+
+    // 0x338: 0xA206
+    I = 0x206;
+
+    // 0x33A: 0x668C
+    V[0x6] = 0x8C;
+
+    // 0x33C: 0x678C
+    V[0x7] = 0x8C;
+
+    // 0x33E: 0x8764
+    V[0xF] = V[0x6] > (0xFF - V[0x7]) ? 1 : 0;
+    V[0x7] += V[0x6];
+
+    // 0x340: 0x4718
+    pc = V[0x7] != 0x18 ? 0x344 : 0x342;
+    return 12;
+}
+
+int block_32C(NativeContext& context)
+{
+    std::uint8_t* V = context.V;
+    std::uint16_t& I = context.I;
+    std::uint16_t& pc = context.pc;
+
+    // 0x32C: 0xDAB4
+    pc = 0x32C;
+    if (context.interpret(0xB40B0A18))
+    {
+        return 1;
+    }
+
+    // 0x32E: 0x6B1A
+    V[0xB] = 0x1A;
+
+    // 0x330: 0xA22A
+    I = 0x22A;
+
+    // 0x332: 0xD8B4
+    pc = 0x332;
+    if (context.interpret(0xB40B0818))
+    {
+        return 4;
+    }
+
+    // 0x334: 0xA21A
+    I = 0x21A;
+
+    // 0x336: 0xD9B4
+    pc = 0x336;
+    if (context.interpret(0xB40B0918))
+    {
+        return 6;
+    }
+
+    // 0x338: 0xA206
+    I = 0x206;
+
+    // 0x33A: 0x668C
+    V[0x6] = 0x8C;
+
+    // 0x33C: 0x678C
+    V[0x7] = 0x8C;
+
+    // 0x33E: 0x8764
+    V[0xF] = V[0x6] > (0xFF - V[0x7]) ? 1 : 0;
+    V[0x7] += V[0x6];
+
+    // 0x340: 0x4718
+    pc = V[0x7] != 0x18 ? 0x344 : 0x342;
+    return 11;
+}
+
+int block_342(NativeContext& context)
+{
+    std::uint8_t* V = context.V;
+    std::uint16_t& I = context.I;
+    std::uint16_t& pc = context.pc;
+
+    // 0x342: 0xA202
+    I = 0x202;
+
+    // 0x344: 0xDAB4
+    pc = 0x344;
+    if (context.interpret(0xB40B0A18))
+    {
+        return 2;
+    }
+
+    // 0x346: 0x682C
+    V[0x8] = 0x2C;
+
+    // 0x348: 0x6930
+    V[0x9] = 0x30;
+
+    // 0x34A: 0x6A34
+    V[0xA] = 0x34;
+
+    // 0x34C: 0x6B01
+    V[0xB] = 0x01;
+
+    // 0x34E: 0xA22A
+    I = 0x22A;
+
+    // 0x350: 0xD8B4
+    pc = 0x350;
+    if (context.interpret(0xB40B0818))
+    {
+        return 8;
+    }
+
+    // 0x352: 0xA21E
+    I = 0x21E;
+
+    // 0x354: 0xD9B4
+    pc = 0x354;
+    if (context.interpret(0xB40B0918))
+    {
+        return 10;
+    }
+
+    // 0x356: 0xA206
+    I = 0x206;
+
+    // 0x358: 0x668C
+    V[0x6] = 0x8C;
+
+    // 0x35A: 0x6778
+    V[0x7] = 0x78;
+
+    // 0x35C: 0x8765
+    V[0xF] = V[0x6] > V[0x7] ? 0 : 1;
+    V[0x7] -= V[0x6];
+
+    // 0x35E: 0x47EC
+    pc = V[0x7] != 0xEC ? 0x362 : 0x360;
+    return 15;
+}
+
+int block_344(NativeContext& context)
+{
+    std::uint8_t* V = context.V;
+    std::uint16_t& I = context.I;
+    std::uint16_t& pc = context.pc;
+
+    // 0x344: 0xDAB4
+    pc = 0x344;
+    if (context.interpret(0xB40B0A18))
+    {
+        return 1;
+    }
+
+    // 0x346: 0x682C
+    V[0x8] = 0x2C;
+
+    // 0x348: 0x6930
+    V[0x9] = 0x30;
+
+    // 0x34A: 0x6A34
+    V[0xA] = 0x34;
+
+    // 0x34C: 0x6B01
+    V[0xB] = 0x01;
+
+    // 0x34E: 0xA22A
+    I = 0x22A;
+
+    // 0x350: 0xD8B4
+    pc = 0x350;
+    if (context.interpret(0xB40B0818))
+    {
+        return 7;
+    }
+
+    // 0x352: 0xA21E
+    I = 0x21E;
+
+    // 0x354: 0xD9B4
+    pc = 0x354;
+    if (context.interpret(0xB40B0918))
+    {
+        return 9;
+    }
+
+    // 0x356: 0xA206
+    I = 0x206;
+
+    // 0x358: 0x668C
+    V[0x6] = 0x8C;
+
+    // 0x35A: 0x6778
+    V[0x7] = 0x78;
+
+    // 0x35C: 0x8765
+    V[0xF] = V[0x6] > V[0x7] ? 0 : 1;
+    V[0x7] -= V[0x6];
+
+    // 0x35E: 0x47EC
+    pc = V[0x7] != 0xEC ? 0x362 : 0x360;
+    return 14;
+}
+
+int block_360(NativeContext& context)
+{
+    std::uint8_t* V = context.V;
+    std::uint16_t& I = context.I;
+    std::uint16_t& pc = context.pc;
+
+    // 0x360: 0xA202
+    I = 0x202;
+
+    // 0x362: 0xDAB4
+    pc = 0x362;
+    if (context.interpret(0xB40B0A18))
+    {
+        return 2;
+    }
+
+    // 0x364: 0x6B06
+    V[0xB] = 0x06;
+
+    // 0x366: 0xA22A
+    I = 0x22A;
+
+    // 0x368: 0xD8B4
+    pc = 0x368;
+    if (context.interpret(0xB40B0818))
+    {
+        return 5;
+    }
+
+    // 0x36A: 0xA222
+    I = 0x222;
+
+    // 0x36C: 0xD9B4
+    pc = 0x36C;
+    if (context.interpret(0xB40B0918))
+    {
+        return 7;
+    }
+
+    // 0x36E: 0xA206
+    I = 0x206;
+
+    // 0x370: 0x66E0
+    V[0x6] = 0xE0;
+
+    // 0x372: 0x866E
+    V[0xF] = V[0x6] >> 7;
+    V[0x6] = V[0x6] << 1;
+
+    // 0x374: 0x46C0
+    pc = V[0x6] != 0xC0 ? 0x378 : 0x376;
+    return 11;
+}
+
+int block_362(NativeContext& context)
+{
+    std::uint8_t* V = context.V;
+    std::uint16_t& I = context.I;
+    std::uint16_t& pc = context.pc;
+
+    // 0x362: 0xDAB4
+    pc = 0x362;
+    if (context.interpret(0xB40B0A18))
+    {
+        return 1;
+    }
+
+    // 0x364: 0x6B06
+    V[0xB] = 0x06;
+
+    // 0x366: 0xA22A
+    I = 0x22A;
+
+    // 0x368: 0xD8B4
+    pc = 0x368;
+    if (context.interpret(0xB40B0818))
+    {
+        return 4;
+    }
+
+    // 0x36A: 0xA222
+    I = 0x222;
+
+    // 0x36C: 0xD9B4
+    pc = 0x36C;
+    if (context.interpret(0xB40B0918))
+    {
+        return 6;
+    }
+
+    // 0x36E: 0xA206
+    I = 0x206;
+
+    // 0x370: 0x66E0
+    V[0x6] = 0xE0;
+
+    // 0x372: 0x866E
+    V[0xF] = V[0x6] >> 7;
+    V[0x6] = V[0x6] << 1;
+
+    // 0x374: 0x46C0
+    pc = V[0x6] != 0xC0 ? 0x378 : 0x376;
+    return 10;
+}
+
+int block_376(NativeContext& context)
+{
+    std::uint8_t* V = context.V;
+    std::uint16_t& I = context.I;
+    std::uint16_t& pc = context.pc;
+
+    // 0x376: 0xA202
+    I = 0x202;
+
+    // 0x378: 0xDAB4
+    pc = 0x378;
+    if (context.interpret(0xB40B0A18))
+    {
+        return 2;
+    }
+
+    // 0x37A: 0x6B0B
+    V[0xB] = 0x0B;
+
+    // 0x37C: 0xA22A
+    I = 0x22A;
+
+    // 0x37E: 0xD8B4
+    pc = 0x37E;
+    if (context.interpret(0xB40B0818))
+    {
+        return 5;
+    }
+
+    // 0x380: 0xA236
+    I = 0x236;
+
+    // 0x382: 0xD9B4
+    pc = 0x382;
+    if (context.interpret(0xB40B0918))
+    {
+        return 7;
+    }
+
+    // 0x384: 0xA206
+    I = 0x206;
+
+    // 0x386: 0x660F
+    V[0x6] = 0x0F;
+
+    // 0x388: 0x8666
+    V[0xF] = V[0x6] & 0x1;
+    V[0x6] = V[0x6] >> 1;
+
+    // 0x38A: 0x4607
+    pc = V[0x6] != 0x07 ? 0x38E : 0x38C;
+    return 11;
+}
+
+int block_378(NativeContext& context)
+{
+    std::uint8_t* V = context.V;
+    std::uint16_t& I = context.I;
+    std::uint16_t& pc = context.pc;
+
+    // 0x378: 0xDAB4
+    pc = 0x378;
+    if (context.interpret(0xB40B0A18))
+    {
+        return 1;
+    }
+
+    // 0x37A: 0x6B0B
+    V[0xB] = 0x0B;
+
+    // 0x37C: 0xA22A
+    I = 0x22A;
+
+    // 0x37E: 0xD8B4
+    pc = 0x37E;
+    if (context.interpret(0xB40B0818))
+    {
+        return 4;
+    }
+
+    // 0x380: 0xA236
+    I = 0x236;
+
+    // 0x382: 0xD9B4
+    pc = 0x382;
+    if (context.interpret(0xB40B0918))
+    {
+        return 6;
+    }
+
+    // 0x384: 0xA206
+    I = 0x206;
+
+    // 0x386: 0x660F
+    V[0x6] = 0x0F;
+
+    // 0x388: 0x8666
+    V[0xF] = V[0x6] & 0x1;
+    V[0x6] = V[0x6] >> 1;
+
+    // 0x38A: 0x4607
+    pc = V[0x6] != 0x07 ? 0x38E : 0x38C;
+    return 10;
+}
+
+int block_38C(NativeContext& context)
+{
+    std::uint8_t* V = context.V;
+    std::uint16_t& I = context.I;
+    std::uint16_t& pc = context.pc;
+
+    // 0x38C: 0xA202
+    I = 0x202;
+
+    // 0x38E: 0xDAB4
+    pc = 0x38E;
+    if (context.interpret(0xB40B0A18))
+    {
+        return 2;
+    }
+
+    // 0x390: 0x6B10
+    V[0xB] = 0x10;
+
+    // 0x392: 0xA23A
+    I = 0x23A;
+
+    // 0x394: 0xD8B4
+    pc = 0x394;
+    if (context.interpret(0xB40B0818))
+    {
+        return 5;
+    }
+
+    // 0x396: 0xA21E
+    I = 0x21E;
+
+    // 0x398: 0xD9B4
+    pc = 0x398;
+    if (context.interpret(0xB40B0918))
+    {
+        return 7;
+    }
+
+    // 0x39A: 0xA3E8
+    I = 0x3E8;
+
+    // 0x39C: 0x6000
+    V[0x0] = 0x00;
+
+    // 0x39E: 0x6130
+    V[0x1] = 0x30;
+
+    // 0x3A0: 0xF155
+    pc = 0x3A0;
+    if (context.interpret(0x55050122))
+    {
+        return 11;
+    }
+
+    // 0x3A2: 0xA3E9
+    I = 0x3E9;
+
+    // 0x3A4: 0xF065
+    pc = 0x3A4;
+    if (context.interpret(0x65060023))
+    {
+        return 13;
+    }
+
+    // 0x3A6: 0xA206
+    I = 0x206;
+
+    // 0x3A8: 0x4030
+    pc = V[0x0] != 0x30 ? 0x3AC : 0x3AA;
+    return 15;
+}
+
+int block_38E(NativeContext& context)
+{
+    std::uint8_t* V = context.V;
+    std::uint16_t& I = context.I;
+    std::uint16_t& pc = context.pc;
+
+    // 0x38E: 0xDAB4
+    pc = 0x38E;
+    if (context.interpret(0xB40B0A18))
+    {
+        return 1;
+    }
+
+    // 0x390: 0x6B10
+    V[0xB] = 0x10;
+
+    // 0x392: 0xA23A
+    I = 0x23A;
+
+    // 0x394: 0xD8B4
+    pc = 0x394;
+    if (context.interpret(0xB40B0818))
+    {
+        return 4;
+    }
+
+    // 0x396: 0xA21E
+    I = 0x21E;
+
+    // 0x398: 0xD9B4
+    pc = 0x398;
+    if (context.interpret(0xB40B0918))
+    {
+        return 6;
+    }
+
+    // 0x39A: 0xA3E8
+    I = 0x3E8;
+
+    // 0x39C: 0x6000
+    V[0x0] = 0x00;
+
+    // 0x39E: 0x6130
+    V[0x1] = 0x30;
+
+    // 0x3A0: 0xF155
+    pc = 0x3A0;
+    if (context.interpret(0x55050122))
+    {
+        return 10;
+    }
+
+    // 0x3A2: 0xA3E9
+    I = 0x3E9;
+
+    // 0x3A4: 0xF065
+    pc = 0x3A4;
+    if (context.interpret(0x65060023))
+    {
+        return 12;
+    }
+
+    // 0x3A6: 0xA206
+    I = 0x206;
+
+    // 0x3A8: 0x4030
+    pc = V[0x0] != 0x30 ? 0x3AC : 0x3AA;
+    return 14;
+}
+
+int block_3AA(NativeContext& context)
+{
+    std::uint8_t* V = context.V;
+    std::uint16_t& I = context.I;
+    std::uint16_t& pc = context.pc;
+
+    // 0x3AA: 0xA202
+    I = 0x202;
+
+    // 0x3AC: 0xDAB4
+    pc = 0x3AC;
+    if (context.interpret(0xB40B0A18))
+    {
+        return 2;
+    }
+
+    // 0x3AE: 0x6B15
+    V[0xB] = 0x15;
+
+    // 0x3B0: 0xA23A
+    I = 0x23A;
+
+    // 0x3B2: 0xD8B4
+    pc = 0x3B2;
+    if (context.interpret(0xB40B0818))
+    {
+        return 5;
+    }
+
+    // 0x3B4: 0xA216
+    I = 0x216;
+
+    // 0x3B6: 0xD9B4
+    pc = 0x3B6;
+    if (context.interpret(0xB40B0918))
+    {
+        return 7;
+    }
+
+    // 0x3B8: 0xA3E8
+    I = 0x3E8;
+
+    // 0x3BA: 0x6689
+    V[0x6] = 0x89;
+
+    // 0x3BC: 0xF633
+    pc = 0x3BC;
+    if (context.interpret(0x33030621))
+    {
+        return 10;
+    }
+
+    // 0x3BE: 0xF265
+    pc = 0x3BE;
+    if (context.interpret(0x65060223))
+    {
+        return 11;
+    }
+
+    // 0x3C0: 0xA202
+    I = 0x202;
+
+    // 0x3C2: 0x3001
+    pc = V[0x0] == 0x01 ? 0x3C6 : 0x3C4;
+    return 13;
+}
+
+int block_3AC(NativeContext& context)
+{
+    std::uint8_t* V = context.V;
+    std::uint16_t& I = context.I;
+    std::uint16_t& pc = context.pc;
+
+    // 0x3AC: 0xDAB4
+    pc = 0x3AC;
+    if (context.interpret(0xB40B0A18))
+    {
+        return 1;
+    }
+
+    // 0x3AE: 0x6B15
+    V[0xB] = 0x15;
+
+    // 0x3B0: 0xA23A
+    I = 0x23A;
+
+    // 0x3B2: 0xD8B4
+    pc = 0x3B2;
+    if (context.interpret(0xB40B0818))
+    {
+        return 4;
+    }
+
+    // 0x3B4: 0xA216
+    I = 0x216;
+
+    // 0x3B6: 0xD9B4
+    pc = 0x3B6;
+    if (context.interpret(0xB40B0918))
+    {
+        return 6;
+    }
+
+    // 0x3B8: 0xA3E8
+    I = 0x3E8;
+
+    // 0x3BA: 0x6689
+    V[0x6] = 0x89;
+
+    // 0x3BC: 0xF633
+    pc = 0x3BC;
+    if (context.interpret(0x33030621))
+    {
+        return 9;
+    }
+
+    // 0x3BE: 0xF265
+    pc = 0x3BE;
+    if (context.interpret(0x65060223))
+    {
+        return 10;
+    }
+
+    // 0x3C0: 0xA202
+    I = 0x202;
+
+    // 0x3C2: 0x3001
+    pc = V[0x0] == 0x01 ? 0x3C6 : 0x3C4;
+    return 12;
+}
+
+int block_3C4(NativeContext& context)
+{
+    std::uint8_t* V = context.V;
+    std::uint16_t& I = context.I;
+    std::uint16_t& pc = context.pc;
+
+    // 0x3C4: 0xA206
+    I = 0x206;
+
+    // 0x3C6: 0x3103
+    pc = V[0x1] == 0x03 ? 0x3CA : 0x3C8;
+    return 2;
+}
+
+int block_3C6(NativeContext& context)
+{
+    std::uint8_t* V = context.V;
+    std::uint16_t& pc = context.pc;
+
+    // 0x3C6: 0x3103
+    pc = V[0x1] == 0x03 ? 0x3CA : 0x3C8;
+    return 1;
+}
+
+int block_3C8(NativeContext& context)
+{
+    std::uint8_t* V = context.V;
+    std::uint16_t& I = context.I;
+    std::uint16_t& pc = context.pc;
+
+    // 0x3C8: 0xA206
+    I = 0x206;
+
+    // 0x3CA: 0x3207
+    pc = V[0x2] == 0x07 ? 0x3CE : 0x3CC;
+    return 2;
+}
+
+int block_3CA(NativeContext& context)
+{
+    std::uint8_t* V = context.V;
+    std::uint16_t& pc = context.pc;
+
+    // 0x3CA: 0x3207
+    pc = V[0x2] == 0x07 ? 0x3CE : 0x3CC;
+    return 1;
+}
+
+int block_3CC(NativeContext& context)
+{
+    std::uint8_t* V = context.V;
+    std::uint16_t& I = context.I;
+    std::uint16_t& pc = context.pc;
+
+    // 0x3CC: 0xA206
+    I = 0x206;
+
+    // 0x3CE: 0xDAB4
+    pc = 0x3CE;
+    if (context.interpret(0xB40B0A18))
+    {
+        return 2;
+    }
+
+    // 0x3D0: 0x6B1A
+    V[0xB] = 0x1A;
+
+    // 0x3D2: 0xA20E
+    I = 0x20E;
+
+    // 0x3D4: 0xD8B4
+    pc = 0x3D4;
+    if (context.interpret(0xB40B0818))
+    {
+        return 5;
+    }
+
+    // 0x3D6: 0xA23E
+    I = 0x23E;
+
+    // 0x3D8: 0xD9B4
+    pc = 0x3D8;
+    if (context.interpret(0xB40B0918))
+    {
+        return 7;
+    }
+
+    // 0x3DA: 0x1248
+    pc = 0x248;
+    return 8;
+}
+
+int block_3CE(NativeContext& context)
+{
+    std::uint8_t* V = context.V;
+    std::uint16_t& I = context.I;
+    std::uint16_t& pc = context.pc;
+
+    // 0x3CE: 0xDAB4
+    pc = 0x3CE;
+    if (context.interpret(0xB40B0A18))
+    {
+        return 1;
+    }
+
+    // 0x3D0: 0x6B1A
+    V[0xB] = 0x1A;
+
+    // 0x3D2: 0xA20E
+    I = 0x20E;
+
+    // 0x3D4: 0xD8B4
+    pc = 0x3D4;
+    if (context.interpret(0xB40B0818))
+    {
+        return 4;
+    }
+
+    // 0x3D6: 0xA23E
+    I = 0x23E;
+
+    // 0x3D8: 0xD9B4
+    pc = 0x3D8;
+    if (context.interpret(0xB40B0918))
+    {
+        return 6;
+    }
+
+    // 0x3DA: 0x1248
+    pc = 0x248;
+    return 7;
+}
+
+int block_3DC(NativeContext& context)
+{
+    std::uint16_t& pc = context.pc;
+
+    // 0x3DC: 0x13DC
+    pc = 0x3DC;
+    return 1;
+}
+
+const NativeBlockInfo BLOCKS[] =
+{
+    { 0x200, 1, &block_200 },
+    { 0x242, 3, &block_242 },
+    { 0x248, 3, &block_248 },
+    { 0x24E, 12, &block_24E },
+    { 0x266, 9, &block_266 },
+    { 0x268, 8, &block_268 },
+    { 0x278, 9, &block_278 },
+    { 0x27A, 8, &block_27A },
+    { 0x28A, 10, &block_28A },
+    { 0x28C, 9, &block_28C },
+    { 0x29E, 9, &block_29E },
+    { 0x2A0, 8, &block_2A0 },
+    { 0x2B0, 8, &block_2B0 },
+    { 0x2B2, 7, &block_2B2 },
+    { 0x2C0, 18, &block_2C0 },
+    { 0x2E4, 11, &block_2E4 },
+    { 0x2E6, 10, &block_2E6 },
+    { 0x2FA, 12, &block_2FA },
+    { 0x2FC, 11, &block_2FC },
+    { 0x312, 12, &block_312 },
+    { 0x314, 11, &block_314 },
+    { 0x32A, 12, &block_32A },
+    { 0x32C, 11, &block_32C },
+    { 0x342, 15, &block_342 },
+    { 0x344, 14, &block_344 },
+    { 0x360, 11, &block_360 },
+    { 0x362, 10, &block_362 },
+    { 0x376, 11, &block_376 },
+    { 0x378, 10, &block_378 },
+    { 0x38C, 15, &block_38C },
+    { 0x38E, 14, &block_38E },
+    { 0x3AA, 13, &block_3AA },
+    { 0x3AC, 12, &block_3AC },
+    { 0x3C4, 2, &block_3C4 },
+    { 0x3C6, 1, &block_3C6 },
+    { 0x3C8, 2, &block_3C8 },
+    { 0x3CA, 1, &block_3CA },
+    { 0x3CC, 8, &block_3CC },
+    { 0x3CE, 7, &block_3CE },
+    { 0x3DC, 1, &block_3DC },
+};
+
+}
+
+extern const NativeProgram opcodeProgram =
+{
+    ROM, sizeof(ROM), BLOCKS, sizeof(BLOCKS) / sizeof(BLOCKS[0]), 0x0A
+};
@@ -0,0 +1,47 @@
+// Quirk profiles read from "<program>.quirks" next to the program.
+
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include "../src/Quirks.h"
+#include "Test.h"
+
+static Quirks readProfile(const char* profile)
+{
+    const std::string path = "quirks.ch8";
+    std::ofstream(path + ".quirks") << profile;
+    const Quirks quirks = Quirks::forProgram(path.c_str());
+    std::remove((path + ".quirks").c_str());
+    return quirks;
+}
+
+TEST(quirksProfileSetsNamedQuirks)
+{
+    const Quirks quirks = readProfile(
+        "# comments and blank lines are skipped\n"
+        "\n"
+        "shiftReadsVy 1\n"
+        "loadStoreIncrementsI 0\n"
+        "jumpAddsVx 1\n"
+        "spritesWrap 0\n"
+        "logicResetsVF 1\n");
+    CHECK(quirks.shiftReadsVy);
+    CHECK(!quirks.loadStoreIncrementsI);
+    CHECK(quirks.jumpAddsVx);
+    CHECK(!quirks.spritesWrap);
+    CHECK(quirks.logicResetsVF);
+    CHECK(Quirks::forProgram("missing.ch8") == Quirks());
+}
+
+// Bad lines are skipped without disturbing the quirks around them
+TEST(quirksProfileSkipsBadLines)
+{
+    const Quirks quirks = readProfile(
+        "shiftReadsVy yes\n"
+        "spritesWrap\n"
+        "fastDraw 1\n"
+        "jumpAddsVx 1\n");
+    Quirks expected;
+    expected.jumpAddsVx = true;
+    CHECK(quirks == expected);
+}
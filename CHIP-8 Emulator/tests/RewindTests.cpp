@@ -0,0 +1,95 @@
+// Stepping back through a rewind buffer must give exactly the states it
+// recorded, across keyframes, deltas and dropped history.
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "../src/Chip8.h"
+#include "../src/Rewind.h"
+#include "Test.h"
+
+static const int FRAMES = 600;
+static const int KEYFRAME_INTERVAL = 7;
+
+struct RecordedFrame
+{
+    std::uint64_t hash;
+    std::uint64_t cycles;
+};
+
+// Runs and records frames while moving the paddle, keeping what each
+// frame left behind
+static void recordFrames(Chip8& chip8, Rewind& rewind, std::vector<RecordedFrame>& history, int count, int keySeed)
+{
+    for (int i = 0; i < count; ++i)
+    {
+        const int phase = (i + keySeed) / 25 % 3;
+        chip8.setKeys(static_cast<std::uint16_t>(phase == 0 ? 1 << 4 : phase == 1 ? 1 << 6 : 0));
+        chip8.runFrame();
+        rewind.record(chip8);
+        history.push_back({ chip8.getStateHash(), chip8.getCycles() });
+    }
+}
+
+// Steps back to the oldest frame the buffer holds, checking every state on
+// the way against history
+static void checkStepsBack(Chip8& chip8, Rewind& rewind, std::vector<RecordedFrame>& history)
+{
+    const std::uint16_t keys = chip8.getKeys();
+    const int available = rewind.getFrameCount();
+    CHECK(available > 1 && available <= static_cast<int>(history.size()));
+    for (int i = 1; i < available; ++i)
+    {
+        history.pop_back();
+        CHECK(rewind.stepBack(chip8));
+        CHECK(chip8.getStateHash() == history.back().hash);
+        CHECK(chip8.getCycles() == history.back().cycles);
+        CHECK(chip8.getKeys() == keys);
+    }
+    CHECK(!rewind.stepBack(chip8));
+    CHECK(rewind.getFrameCount() == 1);
+}
+
+TEST(rewindStepsBackThroughEveryFrame)
+{
+    Chip8 chip8(BREAKOUT_ROM);
+    chip8.seed(1);
+    Rewind rewind(16 * 1024 * 1024, KEYFRAME_INTERVAL);
+    std::vector<RecordedFrame> history;
+    recordFrames(chip8, rewind, history, FRAMES, 0);
+    CHECK(rewind.getFrameCount() == FRAMES);
+    checkStepsBack(chip8, rewind, history);
+}
+
+// Recording after a rewind branches off the frame stepped back to
+TEST(rewindRecordsAgainAfterSteppingBack)
+{
+    Chip8 chip8(BREAKOUT_ROM);
+    chip8.seed(2);
+    Rewind rewind(16 * 1024 * 1024, KEYFRAME_INTERVAL);
+    std::vector<RecordedFrame> history;
+    recordFrames(chip8, rewind, history, FRAMES, 0);
+    for (int i = 0; i < FRAMES / 3; ++i)
+    {
+        CHECK(rewind.stepBack(chip8));
+        history.pop_back();
+    }
+    CHECK(chip8.getStateHash() == history.back().hash);
+    recordFrames(chip8, rewind, history, FRAMES / 2, 10);
+    CHECK(rewind.getFrameCount() == static_cast<int>(history.size()));
+    checkStepsBack(chip8, rewind, history);
+}
+
+// A budget too small for the whole run keeps the newest frames
+TEST(rewindDropsOldestFramesWhenFull)
+{
+    Chip8 chip8(BREAKOUT_ROM);
+    chip8.seed(3);
+    const std::size_t budget = 4 * sizeof(Snapshot);
+    Rewind rewind(budget, KEYFRAME_INTERVAL);
+    std::vector<RecordedFrame> history;
+    recordFrames(chip8, rewind, history, FRAMES, 0);
+    CHECK(rewind.getFrameCount() < FRAMES);
+    CHECK(rewind.getBytesUsed() <= budget);
+    checkStepsBack(chip8, rewind, history);
+}
@@ -0,0 +1,116 @@
+// Generated by the CHIP-8 recompiler from smc.ch8. Do not edit.
+
+#include "NativeProgram.h"
+
+namespace
+{
+
+const std::uint8_t ROM[] =
+{
+    0x60, 0x12, 0x61, 0x06, 0x62, 0x00, 0x74, 0x17, 0xA2, 0x13, 0xF4, 0x33,
+    0xA2, 0x14, 0xF1, 0x55, 0x83, 0x44, 0x73, 0x00, 0x12, 0x06,
+};
+
+int block_200(NativeContext& context)
+{
+    std::uint8_t* V = context.V;
+    std::uint16_t& I = context.I;
+    std::uint16_t& pc = context.pc;
+
+    // 0x200: 0x6012
+    V[0x0] = 0x12;
+
+    // 0x202: 0x6106
+    V[0x1] = 0x06;
+
+    // 0x204: 0x6200
+    V[0x2] = 0x00;
+
+    // 0x206: 0x7417
+    V[0x4] += 0x17;
+
+    // 0x208: 0xA213
+    I = 0x213;
+
+    // 0x20A: 0xF433
+    pc = 0x20A;
+    if (context.interpret(0x33030421))
+    {
+        return 6;
+    }
+
+    // 0x20C: 0xA214
+    I = 0x214;
+
+    // 0x20E: 0xF155
+    pc = 0x20E;
+    if (context.interpret(0x55050122))
+    {
+        return 8;
+    }
+
+    // 0x210: 0x8344
+    V[0xF] = V[0x4] > (0xFF - V[0x3]) ? 1 : 0;
+    V[0x3] += V[0x4];
+
+    // 0x212: 0x7300
+    V[0x3] += 0x00;
+
+    // 0x214: 0x1206
+    pc = 0x206;
+    return 11;
+}
+
+int block_206(NativeContext& context)
+{
+    std::uint8_t* V = context.V;
+    std::uint16_t& I = context.I;
+    std::uint16_t& pc = context.pc;
+
+    // 0x206: 0x7417
+    V[0x4] += 0x17;
+
+    // 0x208: 0xA213
+    I = 0x213;
+
+    // 0x20A: 0xF433
+    pc = 0x20A;
+    if (context.interpret(0x33030421))
+    {
+        return 3;
+    }
+
+    // 0x20C: 0xA214
+    I = 0x214;
+
+    // 0x20E: 0xF155
+    pc = 0x20E;
+    if (context.interpret(0x55050122))
+    {
+        return 5;
+    }
+
+    // 0x210: 0x8344
+    V[0xF] = V[0x4] > (0xFF - V[0x3]) ? 1 : 0;
+    V[0x3] += V[0x4];
+
+    // 0x212: 0x7300
+    V[0x3] += 0x00;
+
+    // 0x214: 0x1206
+    pc = 0x206;
+    return 8;
+}
+
+const NativeBlockInfo BLOCKS[] =
+{
+    { 0x200, 11, &block_200 },
+    { 0x206, 8, &block_206 },
+};
+
+}
+
+extern const NativeProgram selfModifyingProgram =
+{
+    ROM, sizeof(ROM), BLOCKS, sizeof(BLOCKS) / sizeof(BLOCKS[0]), 0x0A
+};
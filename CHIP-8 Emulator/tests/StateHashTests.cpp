@@ -0,0 +1,148 @@
+// The state hash is kept up to date write by write; it must always equal
+// the hash recomputed from the whole machine. Also covers the visited set
+// searches store those hashes in.
+
+#include <cstdint>
+#include <cstdio>
+#include <thread>
+#include <vector>
+#include "../src/Chip8.h"
+#include "../src/NativeProgram.h"
+#include "../src/VisitedSet.h"
+#include "Test.h"
+
+extern const NativeProgram selfModifyingProgram;
+
+static const Dispatch DISPATCHES[] =
+{
+    Dispatch::Switch, Dispatch::Table, Dispatch::Threaded, Dispatch::Block, Dispatch::Jit
+};
+
+static bool matchesRehash(const Chip8& chip8)
+{
+    Snapshot snapshot;
+    chip8.snapshot(snapshot);
+    return chip8.getStateHash() == Chip8::hashSnapshot(snapshot);
+}
+
+// Checks the hash after every slice rather than only at the end, since a
+// missed write can be undone by a later one
+static void checkRunningHash(const char* path, Dispatch dispatch)
+{
+    Chip8 chip8(path, dispatch);
+    chip8.seed(5);
+    bool matches = matchesRehash(chip8);
+    int slice = 64;
+    for (int i = 0; i < 300; ++i)
+    {
+        slice = slice * 7 % 997 + 1;
+        chip8.setKeys(static_cast<std::uint16_t>(i / 20 * 0x2D1B));
+        chip8.run(slice);
+        matches &= matchesRehash(chip8);
+    }
+    if (!matches)
+    {
+        std::cerr << path << ": engine " << static_cast<int>(dispatch) << " lost track of the state hash.\n";
+        CHECK(false);
+    }
+}
+
+TEST(stateHashMatchesRehashWhileRunning)
+{
+    const char* smcPath = writeProgram("hash.ch8", selfModifyingProgram.rom, selfModifyingProgram.romSize);
+    for (Dispatch dispatch : DISPATCHES)
+    {
+        for (const char* path : { BREAKOUT_ROM, IBM_ROM, KEYPAD_ROM, OPCODE_ROM, smcPath })
+        {
+            checkRunningHash(path, dispatch);
+        }
+    }
+    std::remove(smcPath);
+}
+
+TEST(stateHashMatchesRehashAfterRestoreAndReset)
+{
+    Chip8 chip8(BREAKOUT_ROM);
+    chip8.seed(5);
+    chip8.run(100);
+    Snapshot snapshot;
+    chip8.snapshot(snapshot);
+    const std::uint64_t hash = chip8.getStateHash();
+    chip8.run(100);
+    CHECK(chip8.getStateHash() != hash);
+
+    chip8.restore(snapshot);
+    CHECK(chip8.getStateHash() == hash);
+    CHECK(matchesRehash(chip8));
+
+    // One byte of memory and one pixel apart
+    Snapshot changed = snapshot;
+    changed.memory[0x300] ^= 1;
+    changed.machine.display.set(10, 10, changed.machine.display.get(10, 10) == Pixel::White ? Pixel::Black : Pixel::White);
+    chip8.restore(changed);
+    CHECK(chip8.getStateHash() != hash);
+    CHECK(matchesRehash(chip8));
+
+    chip8.reset();
+    chip8.loadProgram(BREAKOUT_ROM);
+    chip8.seed(5);
+    Chip8 fresh(BREAKOUT_ROM);
+    fresh.seed(5);
+    CHECK(chip8.getStateHash() == fresh.getStateHash());
+    CHECK(matchesRehash(chip8));
+}
+
+TEST(visitedSetReportsInsertResults)
+{
+    VisitedSet visited(3);
+    CHECK(visited.getCapacity() == 4);
+    for (std::uint64_t hash = 100; hash < 104; ++hash)
+    {
+        CHECK(visited.insert(hash) == VisitedSet::InsertResult::Inserted);
+    }
+    CHECK(visited.insert(102) == VisitedSet::InsertResult::AlreadyPresent);
+    CHECK(visited.insert(104) == VisitedSet::InsertResult::Full);
+    CHECK(visited.contains(101));
+    CHECK(!visited.contains(104));
+    CHECK(visited.size() == 4);
+
+    visited.clear();
+    CHECK(visited.size() == 0);
+    CHECK(!visited.contains(101));
+    CHECK(visited.insert(104) == VisitedSet::InsertResult::Inserted);
+}
+
+// Threads inserting overlapping ranges must each see a hash as new exactly
+// once between them
+TEST(visitedSetCountsConcurrentInserts)
+{
+    const int threadCount = 4;
+    const int perThread = 100000;
+    VisitedSet visited(1 << 20);
+    std::vector<int> inserted(threadCount);
+    std::vector<std::thread> threads;
+    for (int t = 0; t < threadCount; ++t)
+    {
+        threads.emplace_back([&visited, &inserted, t]()
+        {
+            for (int i = 0; i < perThread; ++i)
+            {
+                const std::uint64_t hash = mixHash(static_cast<std::uint64_t>(i + t * perThread / 2));
+                inserted[t] += visited.insert(hash) == VisitedSet::InsertResult::Inserted;
+            }
+        });
+    }
+    for (std::thread& thread : threads)
+    {
+        thread.join();
+    }
+
+    const std::size_t distinct = perThread + (threadCount - 1) * perThread / 2;
+    int total = 0;
+    for (int count : inserted)
+    {
+        total += count;
+    }
+    CHECK(static_cast<std::size_t>(total) == distinct);
+    CHECK(visited.size() == distinct);
+}
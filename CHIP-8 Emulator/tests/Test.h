@@ -0,0 +1,45 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+
+// Minimal test registry. TEST(name) defines a test that the runner in
+// TestMain.cpp calls; CHECK reports a failed condition and lets the test
+// carry on, so one run lists every mismatch.
+struct TestCase
+{
+    const char* name;
+    void (*function)();
+    TestCase* next;
+
+    TestCase(const char* name, void (*function)());
+};
+
+TestCase* getTests();
+void reportFailure(const char* file, int line, const char* expression);
+
+#define TEST(name) \
+    static void name(); \
+    static TestCase name##Case(#name, name); \
+    static void name()
+
+#define CHECK(expression) \
+    do \
+    { \
+        if (!(expression)) \
+        { \
+            reportFailure(__FILE__, __LINE__, #expression); \
+        } \
+    } while (false)
+
+// ROMs shipped with the emulator, found relative to the working directory
+// as the emulator finds them
+const char* const BREAKOUT_ROM = "Breakout (Brix hack) [David Winter, 1997].ch8";
+const char* const IBM_ROM = "IBM Logo.ch8";
+const char* const KEYPAD_ROM = "Keypad Test [Hap, 2006].ch8";
+const char* const OPCODE_ROM = "test_opcode.ch8";
+
+// Writes a program for a test to a file in the working directory and
+// returns its path
+const char* writeProgram(const char* name, const std::uint8_t* program, std::size_t size);
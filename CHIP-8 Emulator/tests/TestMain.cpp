@@ -0,0 +1,64 @@
+// Runs every test registered with TEST and exits non-zero if any check
+// failed. Run from the directory holding the ROMs.
+//
+// Usage: Tests [name]
+
+#include <cstring>
+#include <fstream>
+#include "Test.h"
+
+static TestCase* tests = nullptr;
+static int failures = 0;
+
+TestCase::TestCase(const char* name, void (*function)()) :
+    name(name),
+    function(function),
+    next(tests)
+{
+    tests = this;
+}
+
+TestCase* getTests()
+{
+    return tests;
+}
+
+void reportFailure(const char* file, int line, const char* expression)
+{
+    std::cerr << file << "(" << line << "): CHECK(" << expression << ") failed.\n";
+    ++failures;
+}
+
+const char* writeProgram(const char* name, const std::uint8_t* program, std::size_t size)
+{
+    std::ofstream file(name, std::ios::binary);
+    file.write(reinterpret_cast<const char*>(program), size);
+    if (!file)
+    {
+        std::cerr << "Unable to write program: " << name << ".\n";
+    }
+    return name;
+}
+
+int main(int argc, char* argv[])
+{
+    int run = 0;
+    int failed = 0;
+    for (TestCase* test = getTests(); test != nullptr; test = test->next)
+    {
+        if (argc > 1 && std::strcmp(argv[1], test->name) != 0)
+        {
+            continue;
+        }
+        const int before = failures;
+        test->function();
+        ++run;
+        if (failures != before)
+        {
+            std::cerr << test->name << " failed.\n";
+            ++failed;
+        }
+    }
+    std::cout << run - failed << " of " << run << " tests passed.\n";
+    return failed == 0 ? 0 : 1;
+}
@@ -0,0 +1,325 @@
+// Translates a CHIP-8 ROM into a C++ translation unit with one function per
+// basic block, for use with Chip8::attachNativeProgram.
+//
+// Usage: Recompiler <rom.ch8> <output.cpp> <symbol>
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <map>
+#include <set>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "../src/Instruction.h"
+#include "../src/Quirks.h"
+
+static const int PROGRAM_START = 512;
+static const int MEMORY_SIZE = 4096;
+static const int MAX_BLOCK_LENGTH = 64;
+
+struct Block
+{
+    std::uint16_t start;
+    std::vector<Instruction> instructions;
+};
+
+static std::string hex(unsigned int value, int digits)
+{
+    char buffer[16];
+    std::snprintf(buffer, sizeof(buffer), "0x%0*X", digits, value);
+    return buffer;
+}
+
+static std::string reg(int index)
+{
+    return "V[" + hex(index, 1) + "]";
+}
+
+static std::uint32_t pack(const Instruction& in)
+{
+    return static_cast<std::uint32_t>(in.op) | in.x << 8 | in.y << 16 | in.kk << 24;
+}
+
+// Emits the body of an instruction the recompiled code handles itself, or
+// returns false if it must go through the interpreter.
+static bool emitInline(std::ostream& out, const Instruction& in, std::uint16_t address, const Quirks& quirks)
+{
+    const std::string x = reg(in.x);
+    const std::string y = reg(in.y);
+    const std::string source = quirks.shiftReadsVy ? y : x;
+    const std::string resetVF = quirks.logicResetsVF ? "    " + reg(0xF) + " = 0;\n" : "";
+    const std::string vf = reg(0xF);
+    const std::string skip = " ? " + hex(address + 4, 3) + " : " + hex(address + 2, 3) + ";\n";
+
+    switch (in.op)
+    {
+    case Op::Jp:
+        out << "    pc = " << hex(in.nnn(), 3) << ";\n";
+        return true;
+    case Op::SeVxByte:
+        out << "    pc = " << x << " == " << hex(in.kk, 2) << skip;
+        return true;
+    case Op::SneVxByte:
+        out << "    pc = " << x << " != " << hex(in.kk, 2) << skip;
+        return true;
+    case Op::SeVxVy:
+        out << "    pc = " << x << " == " << y << skip;
+        return true;
+    case Op::SneVxVy:
+        out << "    pc = " << x << " != " << y << skip;
+        return true;
+    case Op::LdVxByte:
+        out << "    " << x << " = " << hex(in.kk, 2) << ";\n";
+        return true;
+    case Op::AddVxByte:
+        out << "    " << x << " += " << hex(in.kk, 2) << ";\n";
+        return true;
+    case Op::LdVxVy:
+        out << "    " << x << " = " << y << ";\n";
+        return true;
+    case Op::OrVxVy:
+        out << "    " << x << " |= " << y << ";\n" << resetVF;
+        return true;
+    case Op::AndVxVy:
+        out << "    " << x << " &= " << y << ";\n" << resetVF;
+        return true;
+    case Op::XorVxVy:
+        out << "    " << x << " ^= " << y << ";\n" << resetVF;
+        return true;
+    case Op::AddVxVy:
+        out << "    " << vf << " = " << y << " > (0xFF - " << x << ") ? 1 : 0;\n";
+        out << "    " << x << " += " << y << ";\n";
+        return true;
+    case Op::SubVxVy:
+        out << "    " << vf << " = " << y << " > " << x << " ? 0 : 1;\n";
+        out << "    " << x << " -= " << y << ";\n";
+        return true;
+    case Op::ShrVx:
+        out << "    " << vf << " = " << source << " & 0x1;\n";
+        out << "    " << x << " = " << source << " >> 1;\n";
+        return true;
+    case Op::SubnVxVy:
+        out << "    " << vf << " = " << x << " > " << y << " ? 0 : 1;\n";
+        out << "    " << x << " = " << y << " - " << x << ";\n";
+        return true;
+    case Op::ShlVx:
+        out << "    " << vf << " = " << source << " >> 7;\n";
+        out << "    " << x << " = " << source << " << 1;\n";
+        return true;
+    case Op::LdI:
+        out << "    I = " << hex(in.nnn(), 3) << ";\n";
+        return true;
+    case Op::LdVxDt:
+        out << "    " << x << " = delayTimer;\n";
+        return true;
+    case Op::LdDtVx:
+        out << "    delayTimer = " << x << ";\n";
+        return true;
+    case Op::LdStVx:
+        out << "    soundTimer = " << x << ";\n";
+        return true;
+    case Op::AddIVx:
+        out << "    " << vf << " = I + " << x << " > 0xFFF ? 1 : 0;\n";
+        out << "    I += " << x << ";\n";
+        return true;
+    case Op::LdFVx:
+        out << "    I = " << x << " * 0x5;\n";
+        return true;
+    default:
+        return false;
+    }
+}
+
+static void emitBlock(std::ostream& out, const Block& block, const std::vector<std::uint8_t>& memory, const Quirks& quirks)
+{
+    std::ostringstream body;
+    std::uint16_t address = block.start;
+    const int length = static_cast<int>(block.instructions.size());
+    bool terminal = false;
+    for (int i = 0; i < length && !terminal; ++i, address += 2)
+    {
+        const Instruction& in = block.instructions[i];
+        terminal = endsBlock(in.op);
+        body << "\n    // " << hex(address, 3) << ": " << hex(memory[address] << 8 | memory[address + 1], 4) << '\n';
+
+        if (emitInline(body, in, address, quirks))
+        {
+            continue;
+        }
+        if (terminal)
+        {
+            body << "    pc = " << hex(address, 3) << ";\n";
+            body << "    context.interpret(" << hex(pack(in), 8) << ");\n";
+        }
+        else
+        {
+            body << "    pc = " << hex(address, 3) << ";\n";
+            body << "    if (context.interpret(" << hex(pack(in), 8) << "))\n";
+            body << "    {\n        return " << i + 1 << ";\n    }\n";
+        }
+    }
+    if (!terminal)
+    {
+        body << "    pc = " << hex(address, 3) << ";\n";
+    }
+    body << "    return " << length << ";\n";
+
+    // Only bind the parts of the machine state this block touches
+    const std::string text = body.str();
+    out << "int block_" << hex(block.start, 3).substr(2) << "(NativeContext& context)\n{\n";
+    if (text.find("V[") != std::string::npos)
+    {
+        out << "    std::uint8_t* V = context.V;\n";
+    }
+    if (text.find(" I ") != std::string::npos || text.find("    I") != std::string::npos)
+    {
+        out << "    std::uint16_t& I = context.I;\n";
+    }
+    out << "    std::uint16_t& pc = context.pc;\n";
+    if (text.find("delayTimer") != std::string::npos)
+    {
+        out << "    std::uint8_t& delayTimer = context.delayTimer;\n";
+    }
+    if (text.find("soundTimer") != std::string::npos)
+    {
+        out << "    std::uint8_t& soundTimer = context.soundTimer;\n";
+    }
+    out << text << "}\n\n";
+}
+
+// Follows every statically known control transfer from the entry point.
+// Computed jumps (BNNN) are left to the interpreter at run time.
+static std::map<std::uint16_t, Block> findBlocks(const std::vector<std::uint8_t>& memory, int programEnd)
+{
+    std::map<std::uint16_t, Block> blocks;
+    std::vector<std::uint16_t> pending(1, PROGRAM_START);
+    std::set<std::uint16_t> seen;
+
+    while (!pending.empty())
+    {
+        std::uint16_t start = pending.back();
+        pending.pop_back();
+        if (start < PROGRAM_START || start + 1 >= programEnd || !seen.insert(start).second)
+        {
+            continue;
+        }
+
+        Block block;
+        block.start = start;
+        std::uint16_t address = start;
+        while (address + 1 < programEnd && block.instructions.size() < MAX_BLOCK_LENGTH)
+        {
+            Instruction in = decode(memory[address] << 8 | memory[address + 1]);
+            block.instructions.push_back(in);
+            address += 2;
+            if (!endsBlock(in.op))
+            {
+                continue;
+            }
+
+            switch (in.op)
+            {
+            case Op::Jp:
+                pending.push_back(in.nnn());
+                break;
+            case Op::Call:
+                pending.push_back(in.nnn());
+                pending.push_back(address);
+                break;
+            case Op::SeVxByte:
+            case Op::SneVxByte:
+            case Op::SeVxVy:
+            case Op::SneVxVy:
+            case Op::Skp:
+            case Op::Sknp:
+                pending.push_back(address);
+                pending.push_back(address + 2);
+                break;
+            case Op::LdVxK:
+                pending.push_back(address - 2);
+                pending.push_back(address);
+                break;
+            default:
+                break;
+            }
+            break;
+        }
+        if (!block.instructions.empty() && !endsBlock(block.instructions.back().op))
+        {
+            pending.push_back(address);
+        }
+        blocks[start] = block;
+    }
+    return blocks;
+}
+
+int main(int argc, char** argv)
+{
+    if (argc != 4)
+    {
+        std::cerr << "Usage: " << argv[0] << " <rom.ch8> <output.cpp> <symbol>\n";
+        return 1;
+    }
+
+    std::ifstream input(argv[1], std::ios::binary);
+    if (!input)
+    {
+        std::cerr << "Unable to open program: " << argv[1] << ".\n";
+        return 1;
+    }
+    std::vector<std::uint8_t> rom((std::istreambuf_iterator<char>(input)), std::istreambuf_iterator<char>());
+    if (rom.empty() || rom.size() > MEMORY_SIZE - PROGRAM_START)
+    {
+        std::cerr << "Program is empty or too large: " << argv[1] << ".\n";
+        return 1;
+    }
+
+    // Recompiled code is specialized for the program's quirks, read from
+    // the same profile the emulator uses
+    const Quirks quirks = Quirks::forProgram(argv[1]);
+
+    std::vector<std::uint8_t> memory(MEMORY_SIZE, 0);
+    std::copy(rom.begin(), rom.end(), memory.begin() + PROGRAM_START);
+    std::map<std::uint16_t, Block> blocks = findBlocks(memory, PROGRAM_START + static_cast<int>(rom.size()));
+
+    std::ofstream out(argv[2]);
+    if (!out)
+    {
+        std::cerr << "Unable to write: " << argv[2] << ".\n";
+        return 1;
+    }
+
+    out << "// Generated by the CHIP-8 recompiler from " << argv[1] << ". Do not edit.\n\n";
+    out << "#include \"NativeProgram.h\"\n\n";
+    out << "namespace\n{\n\n";
+
+    out << "const std::uint8_t ROM[] =\n{";
+    for (std::size_t i = 0; i < rom.size(); ++i)
+    {
+        out << (i % 12 == 0 ? "\n    " : " ") << hex(rom[i], 2) << ',';
+    }
+    out << "\n};\n\n";
+
+    for (const auto& entry : blocks)
+    {
+        emitBlock(out, entry.second, memory, quirks);
+    }
+
+    out << "const NativeBlockInfo BLOCKS[] =\n{\n";
+    for (const auto& entry : blocks)
+    {
+        out << "    { " << hex(entry.first, 3) << ", " << entry.second.instructions.size()
+            << ", &block_" << hex(entry.first, 3).substr(2) << " },\n";
+    }
+    out << "};\n\n}\n\n";
+
+    out << "extern const NativeProgram " << argv[3] << " =\n{\n";
+    out << "    ROM, sizeof(ROM), BLOCKS, sizeof(BLOCKS) / sizeof(BLOCKS[0]), " << hex(quirks.bits(), 2) << "\n};\n";
+
+    std::cout << "Recompiled " << blocks.size() << " blocks from " << argv[1] << ".\n";
+    return 0;
+}
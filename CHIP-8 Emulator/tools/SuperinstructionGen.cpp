@@ -0,0 +1,210 @@
+// Picks the opcode sequences worth fusing into superinstructions from saved
+// execution profiles and writes the table Chip8.cpp includes.
+//
+// Usage: SuperinstructionGen <Superinstructions.inc> <profile>...
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "../src/Instruction.h"
+#include "../src/Quirks.h"
+
+// Must not exceed Chip8::MAX_FUSIONS
+static const int MAX_FUSIONS = 32;
+// Sequences saving fewer dispatches than this share of all instructions are
+// not worth a handler
+static const double MIN_SHARE = 0.001;
+
+struct Candidate
+{
+    std::vector<Op> ops;
+    std::uint64_t count = 0;
+
+    std::uint64_t saved() const { return count * (ops.size() - 1); }
+};
+
+static bool parseOp(const std::string& name, Op& op)
+{
+    for (int i = 0; i < static_cast<int>(Op::Count); ++i)
+    {
+        if (name == opName(static_cast<Op>(i)))
+        {
+            op = static_cast<Op>(i);
+            return true;
+        }
+    }
+    return false;
+}
+
+// Every opcode but the last must fall through to the next one, and must not
+// store to memory, since the fused handlers are fixed when decoding.
+static bool canFuse(const std::vector<Op>& ops)
+{
+    for (std::size_t i = 0; i < ops.size(); ++i)
+    {
+        Op op = ops[i];
+        if (op == Op::Undecoded || op == Op::Invalid)
+        {
+            return false;
+        }
+        if (i + 1 < ops.size() && (endsBlock(op) || op == Op::LdBVx || op == Op::LdIVx))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+static bool readProfile(const char* path, std::map<std::vector<Op>, std::uint64_t>& counts, std::uint64_t& instructions)
+{
+    std::ifstream input(path);
+    if (!input)
+    {
+        std::cerr << "Unable to open profile: " << path << ".\n";
+        return false;
+    }
+
+    std::string line;
+    while (std::getline(input, line))
+    {
+        std::istringstream fields(line);
+        std::string kind;
+        fields >> kind;
+
+        int length = kind == "pair" ? 2 : kind == "triple" ? 3 : 0;
+        if (kind == "instructions")
+        {
+            std::uint64_t count = 0;
+            fields >> count;
+            instructions += count;
+            continue;
+        }
+        if (length == 0)
+        {
+            continue;
+        }
+
+        std::vector<Op> ops(length);
+        bool valid = true;
+        for (Op& op : ops)
+        {
+            std::string name;
+            fields >> name;
+            valid = valid && parseOp(name, op);
+        }
+        std::uint64_t count = 0;
+        if (!valid || !(fields >> count))
+        {
+            std::cerr << "Malformed profile line in " << path << ": " << line << '\n';
+            return false;
+        }
+        counts[ops] += count;
+    }
+    return true;
+}
+
+int main(int argc, char** argv)
+{
+    if (argc < 3)
+    {
+        std::cerr << "Usage: " << argv[0] << " <Superinstructions.inc> <profile>...\n";
+        return 1;
+    }
+
+    std::map<std::vector<Op>, std::uint64_t> counts;
+    std::uint64_t instructions = 0;
+    for (int i = 2; i < argc; ++i)
+    {
+        if (!readProfile(argv[i], counts, instructions))
+        {
+            return 1;
+        }
+    }
+
+    std::vector<Candidate> candidates;
+    for (const auto& entry : counts)
+    {
+        Candidate candidate;
+        candidate.ops = entry.first;
+        candidate.count = entry.second;
+        if (canFuse(candidate.ops) && candidate.saved() >= MIN_SHARE * instructions)
+        {
+            candidates.push_back(candidate);
+        }
+    }
+
+    std::sort(candidates.begin(), candidates.end(), [](const Candidate& a, const Candidate& b)
+    {
+        return a.saved() > b.saved();
+    });
+    if (candidates.size() > MAX_FUSIONS)
+    {
+        candidates.resize(MAX_FUSIONS);
+    }
+    // Chip8::fuse takes the first match, so longer sequences go first
+    std::stable_sort(candidates.begin(), candidates.end(), [](const Candidate& a, const Candidate& b)
+    {
+        return a.ops.size() > b.ops.size();
+    });
+
+    std::ofstream out(argv[1]);
+    if (!out)
+    {
+        std::cerr << "Unable to write: " << argv[1] << ".\n";
+        return 1;
+    }
+
+    out << "// Generated by tools/SuperinstructionGen from " << instructions << " profiled instructions:\n";
+    for (int i = 2; i < argc; ++i)
+    {
+        out << "//   " << argv[i] << '\n';
+    }
+    out << "// Do not edit; capture new profiles and regenerate instead.\n\n";
+
+    out << "const Chip8::Fusion Chip8::FUSIONS[] =\n{\n";
+    for (const Candidate& candidate : candidates)
+    {
+        std::string ops;
+        for (Op op : candidate.ops)
+        {
+            ops += std::string(ops.empty() ? "" : ", ") + "Op::" + opName(op);
+        }
+
+        char share[16];
+        std::snprintf(share, sizeof(share), "%.2f", 100.0 * candidate.saved() / instructions);
+        out << "    // " << share << "% fewer dispatches\n";
+        out << "    { " << candidate.ops.size() << ", { " << ops << " } },\n";
+    }
+    if (candidates.empty())
+    {
+        out << "    { 0, {} },\n";
+    }
+    out << "};\n\n";
+    out << "const int Chip8::FUSION_COUNT = " << candidates.size() << ";\n\n";
+
+    // Handlers of opcodes with quirks are instantiated per policy
+    out << "template <class Q>\nconst Chip8::Handler Chip8::Policy<Q>::FUSED_HANDLERS[] =\n{\n";
+    for (const Candidate& candidate : candidates)
+    {
+        std::string handlers;
+        for (Op op : candidate.ops)
+        {
+            handlers += std::string(handlers.empty() ? "" : ", ") + "&Chip8::op" + opName(op) + (affectedByQuirks(op) ? "<Q>" : "");
+        }
+        out << "    &Chip8::opSequence<" << handlers << ">,\n";
+    }
+    if (candidates.empty())
+    {
+        out << "    nullptr,\n";
+    }
+    out << "};\n";
+
+    std::cout << "Selected " << candidates.size() << " superinstructions from " << instructions << " instructions.\n";
+    return 0;
+}